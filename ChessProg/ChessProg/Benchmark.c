@@ -0,0 +1,465 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Benchmark.h"
+#include "GameLogic.h"
+#include "TranspositionTable.h"
+
+/*
+ * Search the root moves by iterative deepening up to the depth of the given context, with its settings (move
+ * ordering...), and measure it. The transposition table is cleared first, so every benchmark starts from the same
+ * state.
+ */
+void benchmarkSearch(SearchContext* context, BoardState* state, const MoveBuffer* moves, SearchBenchmark* result)
+{
+	clearTranspositionTable();
+
+	long long startTime = getTimeInMs();
+	iterativeDeepening(context, state, moves, state->isBlackTurn, context->maxDepth, &(result->bestIndex));
+	result->timeInMs = getTimeInMs() - startTime;
+	result->nodes = context->nodes;
+	result->qnodes = context->qnodes;
+	result->branchingFactor = pow((double)context->nodes, 1.0 / context->maxDepth);
+	addTranspositionTableStats(&(context->ttStats));
+}
+
+/* Returns by how many percents the boards of the search changed compared to the base search. */
+int getNodesChange(const SearchBenchmark* base, const SearchBenchmark* search)
+{
+	if (base->nodes == 0)
+		return 0;
+
+	return (int)((((long long)search->nodes - (long long)base->nodes) * 100) / (long long)base->nodes);
+}
+
+/* Returns true if there is a benchmark of the given name (BENCH_ORDERING, BENCH_QUIESCENCE, BENCH_PVS...). */
+bool isBenchmarkName(const char* name)
+{
+	return ((0 == strcmp(BENCH_ORDERING, name)) || (0 == strcmp(BENCH_QUIESCENCE, name)) ||
+			(0 == strcmp(BENCH_PVS, name)) || (0 == strcmp(BENCH_ASPIRATION, name)) ||
+			(0 == strcmp(BENCH_NULL_MOVE, name)) || (0 == strcmp(BENCH_LMR, name)) ||
+			(0 == strcmp(BENCH_EVALUATION, name)) || (0 == strcmp(BENCH_MOVE_GENERATION, name)) ||
+			(0 == strcmp(BENCH_SLIDING_ATTACKS, name)) || (0 == strcmp(BENCH_PERFT, name)));
+}
+
+/* Turn the feature of the search the benchmark is named after on or off. */
+void setBenchmarkFeature(SearchContext* context, const char* name, bool isEnabled)
+{
+	if (0 == strcmp(BENCH_ORDERING, name))
+		context->isMoveOrdering = isEnabled;
+	else if (0 == strcmp(BENCH_QUIESCENCE, name))
+		context->isQuiescence = isEnabled;
+	else if (0 == strcmp(BENCH_PVS, name))
+		context->isPvs = isEnabled;
+	else if (0 == strcmp(BENCH_ASPIRATION, name))
+		context->isAspiration = isEnabled;
+	else if (0 == strcmp(BENCH_NULL_MOVE, name))
+		context->isNullMovePruning = isEnabled;
+	else if (0 == strcmp(BENCH_LMR, name))
+		context->isLateMoveReduction = isEnabled;
+}
+
+/*
+ * Search the board with a fixed depth, once without the feature of the search the benchmark is named after and
+ * once with it, and print the number of boards each search visited and whether the best move changed.
+ * The other features are set according to the user's settings.
+ */
+void runSearchBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth, const char* name)
+{
+	if (!initTranspositionTable())
+	{
+		g_memError = true;
+		return;
+	}
+
+	BoardState state;
+	initBoardState(&state, board, isBlackTurn);
+	MoveBuffer moves;
+	generateMoves(&state, &moves);
+	if (moves.length == 0)
+	{
+		printf(BENCH_NO_MOVES);
+		return;
+	}
+
+	SearchContext context;
+	SearchBenchmark without, with;
+
+	initSearchContext(&context, depth);
+	applySearchSettings(&context);
+	setBenchmarkFeature(&context, name, false);
+	benchmarkSearch(&context, &state, &moves, &without);
+	printf(BENCH_RESULT, name, BENCH_OFF, without.nodes, without.qnodes, without.branchingFactor, without.timeInMs);
+
+	initSearchContext(&context, depth);
+	applySearchSettings(&context);
+	setBenchmarkFeature(&context, name, true);
+	benchmarkSearch(&context, &state, &moves, &with);
+	printf(BENCH_RESULT, name, BENCH_ON, with.nodes, with.qnodes, with.branchingFactor, with.timeInMs);
+
+	printf(BENCH_CHANGE, getNodesChange(&without, &with),
+		   (without.bestIndex == with.bestIndex) ? "unchanged" : "changed");
+
+	clearTranspositionTable();	// Don't leave scores of a search with other settings to the game
+}
+
+/* Add the board state and the boards below it, up to the given depth, to the boards (as long as there is room). */
+void collectBoards(BoardState* state, int depth, BoardState boards[], int* numOfBoards)
+{
+	if (*numOfBoards >= BOARDS_BENCH_MAX_BOARDS)
+		return;
+
+	boards[(*numOfBoards)++] = *state;
+	if (depth == 0)
+		return;
+
+	MoveBuffer moves;
+	GameStep step;
+	generateMoves(state, &moves);
+	int i;
+	for (i = 0; (i < moves.length) && (*numOfBoards < BOARDS_BENCH_MAX_BOARDS); i++)
+	{
+		initGameStep(state->board, moves.moves[i], &step);
+		doStep(state, &step);
+		collectBoards(state, depth - 1, boards, numOfBoards);
+		undoStep(state, &step);
+	}
+}
+
+/*
+ * Returns a new array of the boards of the game tree of the board up to the given depth (at most
+ * BOARDS_BENCH_MAX_BOARDS of them), and sets numOfBoards to their number. Returns NULL if the allocation failed.
+ */
+BoardState* createBenchmarkBoards(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth, int* numOfBoards)
+{
+	BoardState* boards = (BoardState*)malloc(BOARDS_BENCH_MAX_BOARDS * sizeof(BoardState));
+	if (boards == NULL)
+	{
+		printf("Error: standard function malloc has failed");
+		g_memError = true;
+		return NULL;
+	}
+
+	BoardState state;
+	initBoardState(&state, board, isBlackTurn);
+	*numOfBoards = 0;
+	collectBoards(&state, depth, boards, numOfBoards);
+
+	return boards;
+}
+
+/*
+ * Collect the boards of the game tree of the board up to the given depth (at most BOARDS_BENCH_MAX_BOARDS of them),
+ * and print the average time every evaluator takes to score one of them.
+ */
+void runEvaluationBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth)
+{
+	int numOfBoards;
+	BoardState* boards = createBenchmarkBoards(board, isBlackTurn, depth, &numOfBoards);
+	if (boards == NULL)
+		return;
+
+	int type, i;
+	for (type = 0; type < NUM_OF_EVALUATORS; type++)
+	{
+		EvaluateFunction evaluate = g_evaluators[type].evaluate;
+		unsigned long long numOfEvaluations = 0;
+		volatile int sum = 0;	// Keeps the compiler from dropping the evaluations
+		long long startTime = getTimeInMs();
+		long long timeInMs;
+		do
+		{
+			for (i = 0; i < numOfBoards; i++)
+				sum += evaluate(&(boards[i]), boards[i].isBlackTurn);
+
+			numOfEvaluations += numOfBoards;
+			timeInMs = getTimeInMs() - startTime;
+		} while (timeInMs < BOARDS_BENCH_MIN_TIME_MS);
+
+		printf(EVAL_BENCH_RESULT, g_evaluators[type].name, (timeInMs * 1000000.0) / numOfEvaluations, numOfEvaluations,
+			   numOfBoards);
+	}
+
+	free(boards);
+}
+
+/* A measured part of the move generation: returns a value computed from the board, so it can't be dropped. */
+typedef int (*BoardBenchFunction)(BoardState* state);
+
+/* Generate the pseudo-legal moves of the player to move. */
+int benchPseudoLegalMoves(BoardState* state)
+{
+	MoveBuffer moves;
+	generatePseudoLegalMoves(state, &moves);
+	return moves.length;
+}
+
+/* Generate the legal moves of the player to move. */
+int benchLegalMoves(BoardState* state)
+{
+	MoveBuffer moves;
+	generateMoves(state, &moves);
+	return moves.length;
+}
+
+/* Compute the checkers and the pinned pieces of the player to move. */
+int benchLegalityInfo(BoardState* state)
+{
+	LegalityInfo info;
+	initLegalityInfo(state, &info);
+	return (int)(info.checkers ^ info.pinned);
+}
+
+/* Look up the attacks of a knight, a king and a pawn of the player to move on every square in the attack tables. */
+int benchTableAttacks(BoardState* state)
+{
+	BitBoard attacks = EMPTY_BITBOARD;
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+	{
+		attacks ^= getKnightAttacks(square) ^ getKingAttacks(square) ^
+				   getPawnAttacks(square, state->isBlackTurn);
+	}
+
+	return (int)(attacks ^ (attacks >> 32));
+}
+
+/* Compute the attacks of a knight, a king and a pawn of the player to move on every square with shifts. */
+int benchComputedAttacks(BoardState* state)
+{
+	BitBoard attacks = EMPTY_BITBOARD;
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+	{
+		attacks ^= computeKnightAttacks(square) ^ computeKingAttacks(square) ^
+				   computePawnAttacks(square, state->isBlackTurn);
+	}
+
+	return (int)(attacks ^ (attacks >> 32));
+}
+
+/* Call the function on all the boards for at least BOARDS_BENCH_MIN_TIME_MS, and print its average time. */
+void measureBoardFunction(const char* name, BoardBenchFunction function, BoardState boards[], int numOfBoards)
+{
+	unsigned long long numOfCalls = 0;
+	volatile int sum = 0;	// Keeps the compiler from dropping the calls
+	long long startTime = getTimeInMs();
+	long long timeInMs;
+	int i;
+	do
+	{
+		for (i = 0; i < numOfBoards; i++)
+			sum += function(&(boards[i]));
+
+		numOfCalls += numOfBoards;
+		timeInMs = getTimeInMs() - startTime;
+	} while (timeInMs < BOARDS_BENCH_MIN_TIME_MS);
+
+	printf(MOVEGEN_BENCH_RESULT, name, (timeInMs * 1000000.0) / numOfCalls, numOfCalls, numOfBoards);
+}
+
+/*
+ * Collect the boards of the game tree of the board up to the given depth (at most BOARDS_BENCH_MAX_BOARDS of them),
+ * and print the average time it takes to generate the pseudo-legal and the legal moves of one of them. The attacks of
+ * the knights, kings and pawns on every square are also timed, looked up in the attack tables and computed.
+ */
+void runMoveGenerationBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth)
+{
+	int numOfBoards;
+	BoardState* boards = createBenchmarkBoards(board, isBlackTurn, depth, &numOfBoards);
+	if (boards == NULL)
+		return;
+
+	measureBoardFunction("pseudo-legal", benchPseudoLegalMoves, boards, numOfBoards);
+	measureBoardFunction("legal", benchLegalMoves, boards, numOfBoards);
+	measureBoardFunction("legality info", benchLegalityInfo, boards, numOfBoards);
+	measureBoardFunction("leapers table", benchTableAttacks, boards, numOfBoards);
+	measureBoardFunction("leapers computed", benchComputedAttacks, boards, numOfBoards);
+
+	free(boards);
+}
+
+/* Returns the next pseudo random number of the benchmarks (xorshift64*). */
+BitBoard nextBenchmarkRandom(BitBoard* state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return (*state * 0x2545F4914F6CDD1DULL);
+}
+
+/* Returns the squares occupied on the board of the state. */
+BitBoard getOccupiedSquares(const BoardState* state)
+{
+	BitBoard occupied = EMPTY_BITBOARD;
+	int x, y;
+	for (x = 0; x < BOARD_SIZE; x++)
+	{
+		for (y = 0; y < BOARD_SIZE; y++)
+		{
+			if (state->board[x][y] != EMPTY)
+				occupied |= SQUARE_BIT(SQUARE_INDEX(x, y));
+		}
+	}
+
+	return occupied;
+}
+
+/* The bishop and rook attacks of a way to get the sliding attacks. */
+typedef BitBoard (*SlidingAttacksFunction)(int square, BitBoard occupied);
+typedef struct
+{
+	const char* name;
+	SlidingAttacksFunction bishopAttacks;
+	SlidingAttacksFunction rookAttacks;
+} SlidingAttacks;
+
+/* Returns the number of squares whose bishop or rook attacks differ from the ray walkers with the occupied squares. */
+int countSlidingMismatches(const SlidingAttacks* sliders, BitBoard occupied)
+{
+	int mismatches = 0;
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+	{
+		if ((sliders->bishopAttacks(square, occupied) != computeBishopAttacks(square, occupied)) ||
+			(sliders->rookAttacks(square, occupied) != computeRookAttacks(square, occupied)))
+		{
+			mismatches++;
+		}
+	}
+
+	return mismatches;
+}
+
+/* Returns the bishop and rook attacks of all the squares of the board with the given way, xored together. */
+BitBoard getAllSlidingAttacks(const SlidingAttacks* sliders, BitBoard occupied)
+{
+	BitBoard attacks = EMPTY_BITBOARD;
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+		attacks ^= sliders->bishopAttacks(square, occupied) ^ sliders->rookAttacks(square, occupied);
+
+	return attacks;
+}
+
+/*
+ * Validate the sliding attacks of the tables, by magic index, against the ray walkers: on every square of the
+ * boards of the game tree of the board up to the given depth, and of SLIDERS_BENCH_RANDOM_POSITIONS random
+ * occupancies. Then print the average time each of them takes for the bishop and rook attacks of all the squares of
+ * a board.
+ */
+void runSlidingAttacksBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth)
+{
+	const SlidingAttacks sliders[] =
+	{
+		{ "rays", computeBishopAttacks, computeRookAttacks },
+		{ "magic", getBishopAttacks, getRookAttacks }
+	};
+	int numOfSliders = sizeof(sliders) / sizeof(sliders[0]);
+
+	int numOfBoards;
+	BoardState* boards = createBenchmarkBoards(board, isBlackTurn, depth, &numOfBoards);
+	if (boards == NULL)
+		return;
+
+	BitBoard* occupancies = (BitBoard*)malloc(numOfBoards * sizeof(BitBoard));
+	if (occupancies == NULL)
+	{
+		printf("Error: standard function malloc has failed");
+		g_memError = true;
+		free(boards);
+		return;
+	}
+
+	int i, j;
+	for (i = 0; i < numOfBoards; i++)
+		occupancies[i] = getOccupiedSquares(&(boards[i]));
+	free(boards);
+
+	// Validate on the boards, then on random occupancies (of about a quarter of the squares, as in a midgame)
+	for (j = 1; j < numOfSliders; j++)
+	{
+		int mismatches = 0;
+		BitBoard state = SLIDERS_BENCH_SEED;
+		for (i = 0; i < numOfBoards; i++)
+			mismatches += countSlidingMismatches(&(sliders[j]), occupancies[i]);
+		for (i = 0; i < SLIDERS_BENCH_RANDOM_POSITIONS; i++)
+		{
+			BitBoard occupied = nextBenchmarkRandom(&state) & nextBenchmarkRandom(&state);
+			mismatches += countSlidingMismatches(&(sliders[j]), occupied);
+		}
+		printf(SLIDERS_BENCH_CHECK, sliders[j].name, mismatches, numOfBoards + SLIDERS_BENCH_RANDOM_POSITIONS);
+	}
+
+	// Measure
+	for (j = 0; j < numOfSliders; j++)
+	{
+		unsigned long long numOfCalls = 0;
+		volatile BitBoard sum = 0;	// Keeps the compiler from dropping the calls
+		long long startTime = getTimeInMs();
+		long long timeInMs;
+		do
+		{
+			for (i = 0; i < numOfBoards; i++)
+				sum ^= getAllSlidingAttacks(&(sliders[j]), occupancies[i]);
+
+			numOfCalls += numOfBoards;
+			timeInMs = getTimeInMs() - startTime;
+		} while (timeInMs < BOARDS_BENCH_MIN_TIME_MS);
+
+		printf(MOVEGEN_BENCH_RESULT, sliders[j].name, (timeInMs * 1000000.0) / numOfCalls, numOfCalls, numOfBoards);
+	}
+
+	free(occupancies);
+}
+
+/* Returns the number of boards reached by all the sequences of legal moves of the given depth from the board state. */
+unsigned long long countPerftBoards(BoardState* state, int depth)
+{
+	MoveBuffer moves;
+	LegalityInfo info;
+	GameStep step;
+	generatePseudoLegalMoves(state, &moves);
+	initLegalityInfo(state, &info);
+
+	unsigned long long numOfBoards = 0;
+	int i;
+	for (i = 0; i < moves.length; i++)
+	{
+		if (!isLegalMove(state, moves.moves[i], &info))
+			continue;
+
+		if (depth == 1)
+		{	// The boards of the last ply are counted without playing their moves
+			numOfBoards++;
+			continue;
+		}
+
+		initGameStep(state->board, moves.moves[i], &step);
+		doStep(state, &step);
+		numOfBoards += countPerftBoards(state, depth - 1);
+		undoStep(state, &step);
+	}
+
+	return numOfBoards;
+}
+
+/*
+ * Count the boards reached by all the sequences of legal moves of every depth from 1 to the given depth (perft), and
+ * print them with the time each count took. The counts of known positions validate the move generator, castlings,
+ * en passant captures and promotions included.
+ */
+void runPerftBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth)
+{
+	BoardState state;
+	initBoardState(&state, board, isBlackTurn);
+
+	int i;
+	for (i = 1; i <= depth; i++)
+	{
+		long long startTime = getTimeInMs();
+		unsigned long long numOfBoards = countPerftBoards(&state, i);
+		printf(PERFT_BENCH_RESULT, i, numOfBoards, getTimeInMs() - startTime);
+	}
+}
@@ -0,0 +1,89 @@
+#ifndef BENCHMARK_
+#define BENCHMARK_
+
+#include "Types.h"
+#include "BoardManager.h"
+#include "Minimax.h"
+
+#define BENCH_ORDERING "ordering"		// Compares the boards visited with and without move ordering
+#define BENCH_QUIESCENCE "quiescence"	// Compares the boards visited and the move found with and without quiescence
+#define BENCH_PVS "pvs"					// Compares the boards visited by a principal variation search and a full one
+#define BENCH_ASPIRATION "aspiration"	// Compares the boards visited with and without aspiration windows
+#define BENCH_NULL_MOVE "null_move"		// Compares the boards visited and the move found with and without null moves
+#define BENCH_LMR "lmr"					// Compares the boards visited and the move found with and without reductions
+#define BENCH_EVALUATION "eval"			// Measures the time of a single evaluation by every evaluator
+#define BENCH_MOVE_GENERATION "movegen"	// Measures the time of generating the moves of a board, and its attacks
+#define BENCH_SLIDING_ATTACKS "sliders"	// Validates and measures the table lookups of the sliding attacks
+#define BENCH_PERFT "perft"				// Counts the leaf boards of the legal move tree, validating the generator
+#define WRONG_BENCHMARK "Unknown benchmark\n"
+#define BENCH_NO_MOVES "The player has no moves to search\n"
+#define BENCH_RESULT "%-12s %-3s %12llu boards (%llu quiescence) EBF %5.2f %8lld ms\n"
+#define BENCH_CHANGE "%+d%% boards, best move %s\n"
+#define BENCH_ON "on"
+#define BENCH_OFF "off"
+#define EVAL_BENCH_RESULT "%-12s %8.1f ns/eval %12llu evaluations of %d boards\n"
+#define MOVEGEN_BENCH_RESULT "%-16s %8.1f ns/board %12llu calls on %d boards\n"
+#define SLIDERS_BENCH_CHECK "%-16s %d mismatches with the ray walkers in %d positions\n"
+#define PERFT_BENCH_RESULT "perft %2d %14llu boards %8lld ms\n"
+
+#define BOARDS_BENCH_MAX_BOARDS 10000	// Maximum number of boards the evaluators and move generators are measured on
+#define BOARDS_BENCH_MIN_TIME_MS 200	// Every evaluator and move generator is measured for at least this long
+#define SLIDERS_BENCH_RANDOM_POSITIONS 100000	// Random occupancies the sliding attacks are validated on
+#define SLIDERS_BENCH_SEED 0x3C6EF372FE94F82AULL
+
+/* The measures of a single fixed depth search of the root moves. */
+typedef struct
+{
+	unsigned long long nodes;	// Number of boards visited
+	unsigned long long qnodes;	// Number of these boards visited by the quiescence search
+	double branchingFactor;		// The effective branching factor: the boards per ply, were the tree uniform
+	long long timeInMs;			// Duration of the search
+	int bestIndex;				// Index of the chosen move in the root moves buffer
+} SearchBenchmark;
+
+/*
+ * Search the root moves by iterative deepening up to the depth of the given context, with its settings (move
+ * ordering...), and measure it. The transposition table is cleared first, so every benchmark starts from the same
+ * state.
+ */
+void benchmarkSearch(SearchContext* context, BoardState* state, const MoveBuffer* moves, SearchBenchmark* result);
+
+/* Returns true if there is a benchmark of the given name (BENCH_ORDERING, BENCH_QUIESCENCE, BENCH_PVS...). */
+bool isBenchmarkName(const char* name);
+
+/*
+ * Search the board with a fixed depth, once without the feature of the search the benchmark is named after and
+ * once with it, and print the number of boards each search visited and whether the best move changed.
+ * The other features are set according to the user's settings.
+ */
+void runSearchBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth, const char* name);
+
+/*
+ * Collect the boards of the game tree of the board up to the given depth (at most BOARDS_BENCH_MAX_BOARDS of them),
+ * and print the average time every evaluator takes to score one of them.
+ */
+void runEvaluationBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth);
+
+/*
+ * Collect the boards of the game tree of the board up to the given depth (at most BOARDS_BENCH_MAX_BOARDS of them),
+ * and print the average time it takes to generate the pseudo-legal and the legal moves of one of them. The attacks of
+ * the knights, kings and pawns on every square are also timed, looked up in the attack tables and computed.
+ */
+void runMoveGenerationBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth);
+
+/*
+ * Validate the sliding attacks of the tables, by magic index, against the ray walkers: on every square of the
+ * boards of the game tree of the board up to the given depth, and of SLIDERS_BENCH_RANDOM_POSITIONS random
+ * occupancies. Then print the average time each of them takes for the bishop and rook attacks of all the squares of
+ * a board.
+ */
+void runSlidingAttacksBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth);
+
+/*
+ * Count the boards reached by all the sequences of legal moves of every depth from 1 to the given depth (perft), and
+ * print them with the time each count took. The counts of known positions validate the move generator, castlings,
+ * en passant captures and promotions included.
+ */
+void runPerftBenchmark(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int depth);
+
+#endif
@@ -0,0 +1,513 @@
+#include "BitBoard.h"
+
+BitBoard g_knightAttacks[NUM_OF_SQUARES];
+BitBoard g_kingAttacks[NUM_OF_SQUARES];
+BitBoard g_pawnAttacks[NUM_OF_PLAYERS][NUM_OF_SQUARES];
+TargetList g_knightTargets[NUM_OF_SQUARES];
+TargetList g_kingTargets[NUM_OF_SQUARES];
+TargetList g_pawnTargets[NUM_OF_PLAYERS][NUM_OF_SQUARES];
+BitBoard g_rayMasks[NUM_OF_DIRECTIONS][NUM_OF_SQUARES];
+
+SlidingMagic g_bishopMagics[NUM_OF_SQUARES];
+SlidingMagic g_rookMagics[NUM_OF_SQUARES];
+
+BitBoard g_bishopAttacksTable[BISHOP_ATTACKS_TABLE_SIZE];
+BitBoard g_rookAttacksTable[ROOK_ATTACKS_TABLE_SIZE];
+
+/*
+ * The magic numbers of the bishops and rooks on every square. They were found by trying sparse random numbers
+ * (the and of three xorshift64* numbers) until one mapped every occupancy of the mask to an index with the same attacks.
+ */
+const BitBoard g_bishopMagicNumbers[NUM_OF_SQUARES] =
+{
+	0x2C10014821040221ULL, 0x02FC0420822A0000ULL, 0x0041140088811002ULL, 0x0084450200124200ULL,
+	0x0042021100C00000ULL, 0xC124442004008210ULL, 0x00104A080D400100ULL, 0x8222010282946040ULL,
+	0x8300082081240900ULL, 0x4000204404004041ULL, 0x0000103904490003ULL, 0x4400040410800800ULL,
+	0x1080011040011000ULL, 0x4800032820100862ULL, 0x0140004210146018ULL, 0x8020022484042000ULL,
+	0x0040000610040103ULL, 0x0C1830909000A090ULL, 0x0210002800491820ULL, 0x6004042041002000ULL,
+	0x02060004010C0400ULL, 0x1002000108260A04ULL, 0x0210889402080268ULL, 0x0042080445108800ULL,
+	0x4008082045101064ULL, 0x0498028020C45102ULL, 0x5006480054002400ULL, 0x1020080011004008ULL,
+	0x1410840080802004ULL, 0xC011050012048481ULL, 0x04020C0982090100ULL, 0x0000404122821800ULL,
+	0x0018200402290800ULL, 0x4018020240189800ULL, 0x2480804100100C00ULL, 0x0402240109040100ULL,
+	0x2040020200082080ULL, 0x0082180200244040ULL, 0x0808020482086804ULL, 0x1008060420005704ULL,
+	0x4081101090108400ULL, 0x0806080282004800ULL, 0x1403008050100100ULL, 0x04A0001148002400ULL,
+	0x000120200C820100ULL, 0x0040008281820300ULL, 0x4004C10202046404ULL, 0x302C048420400104ULL,
+	0x4046808420A20200ULL, 0x0022020101481202ULL, 0x0810150401044104ULL, 0x500004804202002EULL,
+	0x010810D8102C0800ULL, 0x5104A02044092800ULL, 0x0812020204040004ULL, 0x40A2040C04004400ULL,
+	0xA400248808082A20ULL, 0x8001A02108180428ULL, 0xA101000022015010ULL, 0x0110408020411080ULL,
+	0x0000000405104400ULL, 0x0000084002040D10ULL, 0x10000AA20418020CULL, 0x0208600440420020ULL
+};
+const BitBoard g_rookMagicNumbers[NUM_OF_SQUARES] =
+{
+	0x8A80104000800022ULL, 0x8440001000200240ULL, 0x1080100020008008ULL, 0x4480040800900080ULL,
+	0x0880028084008800ULL, 0x2200011008020004ULL, 0x0400009402411810ULL, 0x80800041000D3080ULL,
+	0x0248800880400020ULL, 0x8A01402010014000ULL, 0x0000802000801000ULL, 0x0000808008001000ULL,
+	0x4002000600082010ULL, 0x0106000C22001009ULL, 0x4041000200048100ULL, 0x0002800641000180ULL,
+	0x8000208000400083ULL, 0x0030104040002000ULL, 0x0080818020011000ULL, 0x0001010008100020ULL,
+	0x0018808008000400ULL, 0x8011010008020400ULL, 0x0000040008100201ULL, 0x4600020000409421ULL,
+	0x004180018020C002ULL, 0x1000200080400088ULL, 0x022000808010002AULL, 0x0600080080801000ULL,
+	0x1400080080040080ULL, 0x8044000480020080ULL, 0x0020080C00A31006ULL, 0x0402004200108401ULL,
+	0x6020204000800094ULL, 0x8000200040401000ULL, 0x0190002000808010ULL, 0x2110000800801081ULL,
+	0x4200800400800800ULL, 0x0008800200800400ULL, 0x0008A22804001041ULL, 0x0C01008C02000051ULL,
+	0x0000204000908000ULL, 0x8050004020024000ULL, 0x0020080010004040ULL, 0x0100080010008080ULL,
+	0x8050080004008080ULL, 0x4106002010040400ULL, 0x04010605180C0010ULL, 0x800014208A420001ULL,
+	0x0860960041002200ULL, 0x0004200040100840ULL, 0x9400200811024100ULL, 0x0410008008001080ULL,
+	0x0004240080080180ULL, 0x0400104020040801ULL, 0x0082000401880200ULL, 0x1000012C44840200ULL,
+	0x01C8210010800041ULL, 0x010140010088B061ULL, 0x0000144100082001ULL, 0x1640082010000501ULL,
+	0x0042001008208502ULL, 0x4421000400080201ULL, 0x0000080210008144ULL, 0x4808040080210042ULL
+};
+
+static bool isAttackTablesReady = false;
+
+/* The leaps (deltaX, deltaY) of the knight and the king, in the order their moves are generated. */
+const int g_knightLeaps[MAX_LEAP_TARGETS][2] =
+{
+	{ 1, 2 }, { 2, 1 }, { -1, 2 }, { -2, 1 }, { 1, -2 }, { 2, -1 }, { -1, -2 }, { -2, -1 }
+};
+const int g_kingLeaps[MAX_LEAP_TARGETS][2] =
+{
+	{ 0, 1 }, { 0, -1 }, { 1, 0 }, { -1, 0 }, { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 }
+};
+
+/* The directions a queen moves in (deltaX, deltaY), in the order of the pin rays of LegalityInfo. */
+const int g_directions[NUM_OF_DIRECTIONS][2] =
+{
+	{ 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }
+};
+
+/* Fill the target list of the square with the leaps which stay on the board, and return them as a bitboard. */
+BitBoard initTargetList(int square, const int leaps[][2], int numOfLeaps, TargetList* targets)
+{
+	BitBoard attacks = EMPTY_BITBOARD;
+	targets->length = 0;
+
+	int i;
+	for (i = 0; i < numOfLeaps; i++)
+	{
+		int x = SQUARE_ROW(square) + leaps[i][0];
+		int y = SQUARE_COLUMN(square) + leaps[i][1];
+		if ((x >= 0) && (y >= 0) && (x < BOARD_SIZE) && (y < BOARD_SIZE))
+		{
+			targets->squares[targets->length++] = SQUARE_INDEX(x, y);
+			attacks |= SQUARE_BIT(SQUARE_INDEX(x, y));
+		}
+	}
+
+	return attacks;
+}
+
+/* Returns the squares of the rays of the piece which can block them: the attacks on an empty board, without edges. */
+BitBoard getBlockersMask(int square, BitBoard (*computeAttacks)(int square, BitBoard occupied))
+{
+	BitBoard edges = ((ROW_1_BITBOARD | ROW_8_BITBOARD) & ~(ROW_1_BITBOARD << (BOARD_SIZE * SQUARE_ROW(square)))) |
+					 ((COLUMN_A_BITBOARD | COLUMN_H_BITBOARD) & ~(COLUMN_A_BITBOARD << SQUARE_COLUMN(square)));
+
+	return computeAttacks(square, EMPTY_BITBOARD) & ~edges;
+}
+
+/*
+ * Fill the magics of a sliding piece with its magic numbers, and its attacks table by magic index.
+ */
+void initSlidingMagics(SlidingMagic magics[NUM_OF_SQUARES], const BitBoard magicNumbers[NUM_OF_SQUARES],
+					   BitBoard attacksTable[], BitBoard (*computeAttacks)(int square, BitBoard occupied))
+{
+	int offset = 0;
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+	{
+		SlidingMagic* magic = &(magics[square]);
+		magic->mask = getBlockersMask(square, computeAttacks);
+		magic->magic = magicNumbers[square];
+		magic->shift = NUM_OF_SQUARES - countBits(magic->mask);
+		magic->attacks = attacksTable + offset;
+
+		// Enumerate the subsets of the mask in increasing order (the carry-rippler trick)
+		int index = 0;
+		BitBoard occupied = EMPTY_BITBOARD;
+		do
+		{
+			magic->attacks[(occupied * magic->magic) >> magic->shift] = computeAttacks(square, occupied);
+			index++;
+			occupied = (occupied - magic->mask) & magic->mask;
+		} while (occupied != EMPTY_BITBOARD);
+
+		offset += index;
+	}
+}
+
+/*
+ * Fill the attack tables. Called once at program start, before any move is generated.
+ * The lists keep the order the move generators have always used, so the moves are generated in the same order.
+ */
+void initAttackTables()
+{
+	if (isAttackTablesReady)
+		return;
+
+	int square, player, direction;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+	{
+		g_knightAttacks[square] = initTargetList(square, g_knightLeaps, MAX_LEAP_TARGETS, &(g_knightTargets[square]));
+		g_kingAttacks[square] = initTargetList(square, g_kingLeaps, MAX_LEAP_TARGETS, &(g_kingTargets[square]));
+
+		for (player = 0; player < NUM_OF_PLAYERS; player++)
+		{
+			int advance = (player == BLACK_PLAYER_INDEX) ? -1 : 1;	// Black pawns eat downwards
+			const int pawnLeaps[2][2] = { { advance, 1 }, { advance, -1 } };
+			g_pawnAttacks[player][square] = initTargetList(square, pawnLeaps, 2, &(g_pawnTargets[player][square]));
+		}
+
+		for (direction = 0; direction < NUM_OF_DIRECTIONS; direction++)
+			g_rayMasks[direction][square] = getRayAttacks(square, EMPTY_BITBOARD, g_directions[direction][0],
+														  g_directions[direction][1]);
+	}
+
+	initSlidingMagics(g_bishopMagics, g_bishopMagicNumbers, g_bishopAttacksTable, computeBishopAttacks);
+	initSlidingMagics(g_rookMagics, g_rookMagicNumbers, g_rookAttacksTable, computeRookAttacks);
+
+	isAttackTablesReady = true;
+}
+
+/* -- Conversion functions -- */
+
+/* Returns the type of the given soldier ('m', 'M', 'b', ...), or NO_PIECE_TYPE for an empty square. */
+PieceType getPieceType(char soldier)
+{
+	switch (soldier)
+	{
+		case WHITE_P:
+		case BLACK_P:
+			return PAWN_TYPE;
+		case WHITE_N:
+		case BLACK_N:
+			return KNIGHT_TYPE;
+		case WHITE_B:
+		case BLACK_B:
+			return BISHOP_TYPE;
+		case WHITE_R:
+		case BLACK_R:
+			return ROOK_TYPE;
+		case WHITE_Q:
+		case BLACK_Q:
+			return QUEEN_TYPE;
+		case WHITE_K:
+		case BLACK_K:
+			return KING_TYPE;
+		default:
+			return NO_PIECE_TYPE;
+	}
+}
+
+/* Returns the char representation of the piece type for the black / white player. */
+char getSoldierChar(PieceType type, bool isBlack)
+{
+	switch (type)
+	{
+		case PAWN_TYPE:
+			return isBlack ? BLACK_P : WHITE_P;
+		case KNIGHT_TYPE:
+			return isBlack ? BLACK_N : WHITE_N;
+		case BISHOP_TYPE:
+			return isBlack ? BLACK_B : WHITE_B;
+		case ROOK_TYPE:
+			return isBlack ? BLACK_R : WHITE_R;
+		case QUEEN_TYPE:
+			return isBlack ? BLACK_Q : WHITE_Q;
+		case KING_TYPE:
+			return isBlack ? BLACK_K : WHITE_K;
+		default:
+			return EMPTY;
+	}
+}
+
+/* Returns true if the soldier belongs to the black player. */
+bool isBlackSoldier(char soldier)
+{
+	return ((soldier == BLACK_P) || (soldier == BLACK_N) || (soldier == BLACK_B) ||
+			(soldier == BLACK_R) || (soldier == BLACK_Q) || (soldier == BLACK_K));
+}
+
+/* Builds the bitboard representation of the char board. */
+void boardToBitBoards(char board[BOARD_SIZE][BOARD_SIZE], BitBoards* bitBoards)
+{
+	clearBitBoards(bitBoards);
+
+	int i, j; // i = row, j = column
+	for (i = 0; i < BOARD_SIZE; i++)
+	{
+		for (j = 0; j < BOARD_SIZE; j++)
+		{
+			PieceType type = getPieceType(board[i][j]);
+			if (type != NO_PIECE_TYPE)
+				addBitBoardPiece(bitBoards, type, isBlackSoldier(board[i][j]), SQUARE_INDEX(i, j));
+		}
+	}
+}
+
+/* Builds the char board represented by the bitboards. */
+void bitBoardsToBoard(const BitBoards* bitBoards, char board[BOARD_SIZE][BOARD_SIZE])
+{
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+		board[SQUARE_ROW(square)][SQUARE_COLUMN(square)] = EMPTY;
+
+	int player, type;
+	for (player = 0; player < NUM_OF_PLAYERS; player++)
+	{
+		for (type = 0; type < NUM_OF_PIECE_TYPES; type++)
+		{
+			BitBoard pieces = bitBoards->pieces[player][type];
+			while (pieces != EMPTY_BITBOARD)
+			{
+				square = popFirstSquare(&pieces);
+				board[SQUARE_ROW(square)][SQUARE_COLUMN(square)] = getSoldierChar((PieceType)type,
+																				  (player == BLACK_PLAYER_INDEX));
+			}
+		}
+	}
+}
+
+/* -- Update functions -- */
+
+/* Remove all the pieces from the bitboards. */
+void clearBitBoards(BitBoards* bitBoards)
+{
+	int player, type;
+	for (player = 0; player < NUM_OF_PLAYERS; player++)
+	{
+		for (type = 0; type < NUM_OF_PIECE_TYPES; type++)
+			bitBoards->pieces[player][type] = EMPTY_BITBOARD;
+
+		bitBoards->occupied[player] = EMPTY_BITBOARD;
+	}
+
+	bitBoards->all = EMPTY_BITBOARD;
+}
+
+/* Place a piece of the given type and player on the (vacant) square. */
+void addBitBoardPiece(BitBoards* bitBoards, PieceType type, bool isBlack, int square)
+{
+	BitBoard bit = SQUARE_BIT(square);
+	bitBoards->pieces[isBlack][type] |= bit;
+	bitBoards->occupied[isBlack] |= bit;
+	bitBoards->all |= bit;
+}
+
+/* Remove the piece of the given type and player from the square. */
+void removeBitBoardPiece(BitBoards* bitBoards, PieceType type, bool isBlack, int square)
+{
+	BitBoard mask = ~SQUARE_BIT(square);
+	bitBoards->pieces[isBlack][type] &= mask;
+	bitBoards->occupied[isBlack] &= mask;
+	bitBoards->all &= mask;
+}
+
+/* -- Query functions -- */
+
+/* Returns the number of squares in the bitboard. */
+int countBits(BitBoard bitBoard)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(bitBoard);
+#else
+	// Portable "SWAR" population count: sum bits in pairs, nibbles and bytes, then add up all bytes
+	bitBoard = bitBoard - ((bitBoard >> 1) & 0x5555555555555555ULL);
+	bitBoard = (bitBoard & 0x3333333333333333ULL) + ((bitBoard >> 2) & 0x3333333333333333ULL);
+	bitBoard = (bitBoard + (bitBoard >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((bitBoard * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+#if !defined(__GNUC__)
+/* Lookup table for the De Bruijn bit scan used by getFirstSquare. */
+static const int DE_BRUIJN_SQUARES[NUM_OF_SQUARES] =
+{
+	 0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+	62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+	63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+	46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+};
+#endif
+
+/* Returns the index of the lowest square in the bitboard. The bitboard must not be empty. */
+int getFirstSquare(BitBoard bitBoard)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(bitBoard);
+#else
+	// Isolate the lowest bit and use it to select a unique entry of the De Bruijn sequence
+	return DE_BRUIJN_SQUARES[((bitBoard & (0 - bitBoard)) * 0x03F79D71B4CB0A89ULL) >> 58];
+#endif
+}
+
+/* Returns the index of the lowest square in the bitboard and removes it. The bitboard must not be empty. */
+int popFirstSquare(BitBoard* bitBoard)
+{
+	int square = getFirstSquare(*bitBoard);
+	*bitBoard &= (*bitBoard - 1);
+	return square;
+}
+
+/* Returns the squares a knight standing on the square attacks (from the attack tables). */
+BitBoard getKnightAttacks(int square)
+{
+	return g_knightAttacks[square];
+}
+
+/* Returns the squares a king standing on the square attacks (from the attack tables). */
+BitBoard getKingAttacks(int square)
+{
+	return g_kingAttacks[square];
+}
+
+/* Returns the squares a pawn of the given player standing on the square attacks (eats to), from the attack tables. */
+BitBoard getPawnAttacks(int square, bool isBlack)
+{
+	return g_pawnAttacks[isBlack][square];
+}
+
+/* Computes the squares a knight standing on the square attacks with shifts, without the attack tables. */
+BitBoard computeKnightAttacks(int square)
+{
+	BitBoard bit = SQUARE_BIT(square);
+	BitBoard notA = ~COLUMN_A_BITBOARD;
+	BitBoard notAB = ~(COLUMN_A_BITBOARD | COLUMN_B_BITBOARD);
+	BitBoard notH = ~COLUMN_H_BITBOARD;
+	BitBoard notGH = ~(COLUMN_G_BITBOARD | COLUMN_H_BITBOARD);
+
+	// Shifting by a row is +-8 and by a column is +-1. Masks drop leaps that wrap around the board's sides.
+	return (((bit << 17) & notA) | ((bit << 15) & notH) | ((bit << 10) & notAB) | ((bit << 6) & notGH) |
+			((bit >> 17) & notH) | ((bit >> 15) & notA) | ((bit >> 10) & notGH) | ((bit >> 6) & notAB));
+}
+
+/* Computes the squares a king standing on the square attacks with shifts, without the attack tables. */
+BitBoard computeKingAttacks(int square)
+{
+	BitBoard bit = SQUARE_BIT(square);
+	BitBoard sides = ((bit << 1) & ~COLUMN_A_BITBOARD) | ((bit >> 1) & ~COLUMN_H_BITBOARD);
+	BitBoard row = bit | sides;
+
+	return (sides | (row << 8) | (row >> 8));
+}
+
+/* Computes the squares a pawn of the given player standing on the square attacks, without the attack tables. */
+BitBoard computePawnAttacks(int square, bool isBlack)
+{
+	BitBoard bit = SQUARE_BIT(square);
+
+	if (isBlack)
+		return (((bit >> 9) & ~COLUMN_H_BITBOARD) | ((bit >> 7) & ~COLUMN_A_BITBOARD)); // Black pawns eat downwards
+	else
+		return (((bit << 7) & ~COLUMN_H_BITBOARD) | ((bit << 9) & ~COLUMN_A_BITBOARD)); // White pawns eat upwards
+}
+
+/* Returns the squares attacked along the given direction, up to and including the first occupied square. */
+BitBoard getRayAttacks(int square, BitBoard occupied, int deltaX, int deltaY)
+{
+	BitBoard attacks = EMPTY_BITBOARD;
+	int x = SQUARE_ROW(square) + deltaX;
+	int y = SQUARE_COLUMN(square) + deltaY;
+
+	while ((x >= 0) && (y >= 0) && (x < BOARD_SIZE) && (y < BOARD_SIZE))
+	{
+		BitBoard bit = SQUARE_BIT(SQUARE_INDEX(x, y));
+		attacks |= bit;
+		if (occupied & bit)
+			break;
+
+		x += deltaX;
+		y += deltaY;
+	}
+
+	return attacks;
+}
+
+/*
+ * Returns the squares a bishop standing on the square attacks, the rays stop at the first occupied square.
+ * Looked up in the sliding attack tables, by magic index.
+ */
+BitBoard getBishopAttacks(int square, BitBoard occupied)
+{
+	const SlidingMagic* magic = &(g_bishopMagics[square]);
+	return magic->attacks[((occupied & magic->mask) * magic->magic) >> magic->shift];
+}
+
+/*
+ * Returns the squares a rook standing on the square attacks, the rays stop at the first occupied square.
+ * Looked up in the sliding attack tables, by magic index.
+ */
+BitBoard getRookAttacks(int square, BitBoard occupied)
+{
+	const SlidingMagic* magic = &(g_rookMagics[square]);
+	return magic->attacks[((occupied & magic->mask) * magic->magic) >> magic->shift];
+}
+
+/* Computes the bishop attacks by walking the rays square by square, without the attack tables. */
+BitBoard computeBishopAttacks(int square, BitBoard occupied)
+{
+	return (getRayAttacks(square, occupied, 1, 1) | getRayAttacks(square, occupied, 1, -1) |
+			getRayAttacks(square, occupied, -1, 1) | getRayAttacks(square, occupied, -1, -1));
+}
+
+/* Computes the rook attacks by walking the rays square by square, without the attack tables. */
+BitBoard computeRookAttacks(int square, BitBoard occupied)
+{
+	return (getRayAttacks(square, occupied, 1, 0) | getRayAttacks(square, occupied, -1, 0) |
+			getRayAttacks(square, occupied, 0, 1) | getRayAttacks(square, occupied, 0, -1));
+}
+
+/* Returns true if any piece of the black (isByBlackPlayer == true) or white player attacks the square. */
+bool isSquareAttacked(const BitBoards* bitBoards, int square, bool isByBlackPlayer)
+{
+	return isSquareAttackedThrough(bitBoards, square, isByBlackPlayer, bitBoards->all);
+}
+
+/*
+ * Returns true if any piece of the black (isByBlackPlayer == true) or white player attacks the square, where the rays
+ * of the sliding pieces are blocked by the given occupied squares instead of the pieces of the bitboards.
+ */
+bool isSquareAttackedThrough(const BitBoards* bitBoards, int square, bool isByBlackPlayer, BitBoard occupied)
+{
+	const BitBoard* enemy = bitBoards->pieces[isByBlackPlayer];
+
+	// Attacks are symmetric: a piece on the square would attack the attacker's square in the same pattern.
+	// Pawns are the exception - we look with a pawn of the defending player, which eats in the opposite direction.
+	if (getPawnAttacks(square, !isByBlackPlayer) & enemy[PAWN_TYPE])
+		return true;
+	if (getKnightAttacks(square) & enemy[KNIGHT_TYPE])
+		return true;
+	if (getKingAttacks(square) & enemy[KING_TYPE])
+		return true;
+	if (getBishopAttacks(square, occupied) & (enemy[BISHOP_TYPE] | enemy[QUEEN_TYPE]))
+		return true;
+	if (getRookAttacks(square, occupied) & (enemy[ROOK_TYPE] | enemy[QUEEN_TYPE]))
+		return true;
+
+	return false;
+}
+
+/* Returns true if the king of the black (isBlackKing == true) or white player is in check. */
+bool isBitBoardKingUnderCheck(const BitBoards* bitBoards, bool isBlackKing)
+{
+	BitBoard king = bitBoards->pieces[isBlackKing][KING_TYPE];
+	if (king == EMPTY_BITBOARD)
+		return false; // No king on board (can only happen for invalid boards)
+
+	return isSquareAttacked(bitBoards, getFirstSquare(king), !isBlackKing);
+}
+
+/* Returns the size of the army of the black / white player, counted from the bitboards. */
+Army getBitBoardArmy(const BitBoards* bitBoards, bool isBlackSoldiers)
+{
+	const BitBoard* pieces = bitBoards->pieces[isBlackSoldiers];
+	Army army;
+
+	army.pawns = countBits(pieces[PAWN_TYPE]);
+	army.bishops = countBits(pieces[BISHOP_TYPE]);
+	army.rooks = countBits(pieces[ROOK_TYPE]);
+	army.knights = countBits(pieces[KNIGHT_TYPE]);
+	army.queens = countBits(pieces[QUEEN_TYPE]);
+	army.kings = countBits(pieces[KING_TYPE]);
+
+	return army;
+}
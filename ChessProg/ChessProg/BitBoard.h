@@ -0,0 +1,210 @@
+#ifndef BIT_BOARD_
+#define BIT_BOARD_
+
+#include <stdint.h>
+#include "Types.h"
+
+/*
+ * A set of squares on the game board, one bit per square.
+ * Square <x,y> (x = row, y = column, same indices as the char board) is bit number (x * BOARD_SIZE + y),
+ * so bit 0 is <a,1>, bit 7 is <h,1> and bit 63 is <h,8>.
+ */
+typedef uint64_t BitBoard;
+
+/** -- Bitboard constants -- */
+#define NUM_OF_SQUARES (BOARD_SIZE * BOARD_SIZE)
+#define EMPTY_BITBOARD ((BitBoard)0)
+#define COLUMN_A_BITBOARD ((BitBoard)0x0101010101010101ULL)
+#define COLUMN_B_BITBOARD (COLUMN_A_BITBOARD << 1)
+#define COLUMN_G_BITBOARD (COLUMN_A_BITBOARD << 6)
+#define COLUMN_H_BITBOARD (COLUMN_A_BITBOARD << 7)
+#define ROW_1_BITBOARD ((BitBoard)0xFFULL)
+#define ROW_8_BITBOARD (ROW_1_BITBOARD << 56)
+
+/** -- Square index helpers (x = row, y = column) -- */
+#define SQUARE_INDEX(x, y) (((x) * BOARD_SIZE) + (y))
+#define SQUARE_ROW(square) ((square) / BOARD_SIZE)
+#define SQUARE_COLUMN(square) ((square) % BOARD_SIZE)
+#define SQUARE_BIT(square) (((BitBoard)1) << (square))
+
+/* The piece types, used as indices of the per type bitboards. */
+typedef enum
+{
+	PAWN_TYPE,
+	KNIGHT_TYPE,
+	BISHOP_TYPE,
+	ROOK_TYPE,
+	QUEEN_TYPE,
+	KING_TYPE,
+	NUM_OF_PIECE_TYPES
+} PieceType;
+
+/* Marks an empty square when a piece type is expected. */
+#define NO_PIECE_TYPE NUM_OF_PIECE_TYPES
+
+/* Player indices of the per player arrays. Since bool is false / true, an isBlack flag can be used directly. */
+#define WHITE_PLAYER_INDEX 0
+#define BLACK_PLAYER_INDEX 1
+#define NUM_OF_PLAYERS 2
+
+/*
+ * The bitboard representation of a game board.
+ * It is kept alongside the char board: the console and gui work with the char board, while the engine can query
+ * pieces, occupancy and attacks with bit operations.
+ */
+typedef struct
+{
+	BitBoard pieces[NUM_OF_PLAYERS][NUM_OF_PIECE_TYPES];	// One bitboard per player and piece type
+	BitBoard occupied[NUM_OF_PLAYERS];						// All the squares occupied by each player
+	BitBoard all;											// All the occupied squares on the board
+} BitBoards;
+
+/* The squares a knight, king or pawn standing on a square attacks, in a fixed order (see initAttackTables). */
+#define MAX_LEAP_TARGETS 8
+typedef struct
+{
+	int length;
+	int squares[MAX_LEAP_TARGETS];
+} TargetList;
+
+/*
+ * The attack tables of the knights, kings and pawns: per square (and per player for pawns) the squares attacked from
+ * it, once as a bitboard and once as a list. Filled by initAttackTables, so lookups need no bounds checks.
+ */
+extern BitBoard g_knightAttacks[NUM_OF_SQUARES];
+extern BitBoard g_kingAttacks[NUM_OF_SQUARES];
+extern BitBoard g_pawnAttacks[NUM_OF_PLAYERS][NUM_OF_SQUARES];
+extern TargetList g_knightTargets[NUM_OF_SQUARES];
+extern TargetList g_kingTargets[NUM_OF_SQUARES];
+extern TargetList g_pawnTargets[NUM_OF_PLAYERS][NUM_OF_SQUARES];
+
+/* The directions a queen moves in (deltaX, deltaY): 4 lines and 4 diagonals (see g_directions in BitBoard.c). */
+#define NUM_OF_DIRECTIONS 8
+extern const int g_directions[NUM_OF_DIRECTIONS][2];
+
+/*
+ * The rays of every square: per direction, the squares from the square (without it) to the edge of the board.
+ * The squares a sliding piece attacks in a single direction are its attacks and the ray. Filled by initAttackTables.
+ */
+extern BitBoard g_rayMasks[NUM_OF_DIRECTIONS][NUM_OF_SQUARES];
+
+/*
+ * The sliding attacks of a bishop or a rook standing on a square, looked up by the occupancy of the board.
+ * Only the squares of the mask (the rays from the square without the board edges) can block a ray. The occupied
+ * squares of the mask are hashed to an index of the attacks table: multiplied by a magic number which maps every
+ * occupancy to its own index in the top bits (magic bitboards).
+ */
+typedef struct
+{
+	BitBoard mask;			// The squares which block the rays
+	BitBoard magic;			// The magic number of the square
+	int shift;				// 64 minus the number of bits of the index (the number of squares of the mask)
+	BitBoard* attacks;		// The attacks of every occupancy of the mask, by magic index
+} SlidingMagic;
+
+#define BISHOP_ATTACKS_TABLE_SIZE 5248		// The sum of the occupancies of the bishop masks of all the squares
+#define ROOK_ATTACKS_TABLE_SIZE 102400		// The sum of the occupancies of the rook masks of all the squares
+
+extern SlidingMagic g_bishopMagics[NUM_OF_SQUARES];
+extern SlidingMagic g_rookMagics[NUM_OF_SQUARES];
+
+/*
+ * Fill the attack tables. Called once at program start, before any move is generated.
+ * The lists keep the order the move generators have always used, so the moves are generated in the same order.
+ */
+void initAttackTables();
+
+/* -- Conversion functions -- */
+
+/* Returns the type of the given soldier ('m', 'M', 'b', ...), or NO_PIECE_TYPE for an empty square. */
+PieceType getPieceType(char soldier);
+
+/* Returns the char representation of the piece type for the black / white player. */
+char getSoldierChar(PieceType type, bool isBlack);
+
+/* Returns true if the soldier belongs to the black player. */
+bool isBlackSoldier(char soldier);
+
+/* Builds the bitboard representation of the char board. */
+void boardToBitBoards(char board[BOARD_SIZE][BOARD_SIZE], BitBoards* bitBoards);
+
+/* Builds the char board represented by the bitboards. */
+void bitBoardsToBoard(const BitBoards* bitBoards, char board[BOARD_SIZE][BOARD_SIZE]);
+
+/* -- Update functions -- */
+
+/* Remove all the pieces from the bitboards. */
+void clearBitBoards(BitBoards* bitBoards);
+
+/* Place a piece of the given type and player on the (vacant) square. */
+void addBitBoardPiece(BitBoards* bitBoards, PieceType type, bool isBlack, int square);
+
+/* Remove the piece of the given type and player from the square. */
+void removeBitBoardPiece(BitBoards* bitBoards, PieceType type, bool isBlack, int square);
+
+/* -- Query functions -- */
+
+/* Returns the number of squares in the bitboard. */
+int countBits(BitBoard bitBoard);
+
+/* Returns the index of the lowest square in the bitboard. The bitboard must not be empty. */
+int getFirstSquare(BitBoard bitBoard);
+
+/* Returns the index of the lowest square in the bitboard and removes it. The bitboard must not be empty. */
+int popFirstSquare(BitBoard* bitBoard);
+
+/* Returns the squares a knight standing on the square attacks (from the attack tables). */
+BitBoard getKnightAttacks(int square);
+
+/* Returns the squares a king standing on the square attacks (from the attack tables). */
+BitBoard getKingAttacks(int square);
+
+/* Returns the squares a pawn of the given player standing on the square attacks (eats to), from the attack tables. */
+BitBoard getPawnAttacks(int square, bool isBlack);
+
+/* Computes the squares a knight standing on the square attacks with shifts, without the attack tables. */
+BitBoard computeKnightAttacks(int square);
+
+/* Computes the squares a king standing on the square attacks with shifts, without the attack tables. */
+BitBoard computeKingAttacks(int square);
+
+/* Computes the squares a pawn of the given player standing on the square attacks, without the attack tables. */
+BitBoard computePawnAttacks(int square, bool isBlack);
+
+/*
+ * Returns the squares a bishop standing on the square attacks, the rays stop at the first occupied square.
+ * Looked up in the sliding attack tables, by magic index.
+ */
+BitBoard getBishopAttacks(int square, BitBoard occupied);
+
+/*
+ * Returns the squares a rook standing on the square attacks, the rays stop at the first occupied square.
+ * Looked up in the sliding attack tables, by magic index.
+ */
+BitBoard getRookAttacks(int square, BitBoard occupied);
+
+/* Returns the squares attacked along the given direction, up to and including the first occupied square. */
+BitBoard getRayAttacks(int square, BitBoard occupied, int deltaX, int deltaY);
+
+/* Computes the bishop attacks by walking the rays square by square, without the attack tables. */
+BitBoard computeBishopAttacks(int square, BitBoard occupied);
+
+/* Computes the rook attacks by walking the rays square by square, without the attack tables. */
+BitBoard computeRookAttacks(int square, BitBoard occupied);
+
+/* Returns true if any piece of the black (isByBlackPlayer == true) or white player attacks the square. */
+bool isSquareAttacked(const BitBoards* bitBoards, int square, bool isByBlackPlayer);
+
+/*
+ * Returns true if any piece of the black (isByBlackPlayer == true) or white player attacks the square, where the rays
+ * of the sliding pieces are blocked by the given occupied squares instead of the pieces of the bitboards.
+ */
+bool isSquareAttackedThrough(const BitBoards* bitBoards, int square, bool isByBlackPlayer, BitBoard occupied);
+
+/* Returns true if the king of the black (isBlackKing == true) or white player is in check. */
+bool isBitBoardKingUnderCheck(const BitBoards* bitBoards, bool isBlackKing);
+
+/* Returns the size of the army of the black / white player, counted from the bitboards. */
+Army getBitBoardArmy(const BitBoards* bitBoards, bool isBlackSoldiers);
+
+#endif
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "LinkedList.h"
 #include "BoardManager.h"
 
@@ -142,6 +143,31 @@ Move* createMove(Position* startPos, Position* targetPos)
 	return newMove;
 }
 
+/* Returns the compact encoding of the move. */
+CompactMove encodeMove(const Move* move)
+{
+	int startSquare = SQUARE_INDEX(move->initPos.x, move->initPos.y);
+	int targetSquare = SQUARE_INDEX(move->nextPos.x, move->nextPos.y);
+	PieceType promotionType = (move->promotion == EMPTY) ? NO_PROMOTION_TYPE : getPieceType(move->promotion);
+
+	return COMPACT_MOVE(startSquare, targetSquare, promotionType);
+}
+
+/* Returns the Move struct of the compact move, done by the black (isBlackPlayer == true) or white player. */
+Move decodeMove(CompactMove compactMove, bool isBlackPlayer)
+{
+	Move move;
+	move.initPos.x = SQUARE_ROW(MOVE_START_SQUARE(compactMove));
+	move.initPos.y = SQUARE_COLUMN(MOVE_START_SQUARE(compactMove));
+	move.nextPos.x = SQUARE_ROW(MOVE_TARGET_SQUARE(compactMove));
+	move.nextPos.y = SQUARE_COLUMN(MOVE_TARGET_SQUARE(compactMove));
+
+	PieceType promotionType = MOVE_PROMOTION_TYPE(compactMove);
+	move.promotion = (promotionType == NO_PROMOTION_TYPE) ? EMPTY : getSoldierChar(promotionType, isBlackPlayer);
+
+	return move;
+}
+
 /* A deep copy constructor function for Move structs. */
 Move* cloneMove(Move* original)
 {
@@ -162,87 +188,433 @@ void deleteMove(void* move)
 	free(move);
 }
 
-/* Execute move on the board. In the end of this function the move is deleted. */
+/*
+ * Execute move on the game board, and update the castling rights and en passant square of the game.
+ * In the end of this function the move is deleted.
+ */
 bool executeMove(char board[BOARD_SIZE][BOARD_SIZE], Move* move)
 {
-	GameStep* nextStep = createGameStep(board, move);
-	if (g_memError)
-	{
-		deleteMove((void*)move);
-		return false;
-	}
+	BoardState state;
+	initBoardState(&state, board, isSquareOccupiedByBlackPlayer(board, move->initPos.x, move->initPos.y));
 
-	doStep(board, nextStep);
+	GameStep nextStep;
+	initGameStep(state.board, encodeMove(move), &nextStep);
+	doStep(&state, &nextStep);
 
-	deleteGameStep(nextStep);
+	memcpy(board, state.board, sizeof(state.board));
+	g_castlingRights = state.castlingRights;
+	g_enPassantSquare = state.enPassantSquare;
 	deleteMove((void*)move);
 	return true;
 }
 
-/* A constructor function for GameStep structs. */
-GameStep* createGameStep(char board[BOARD_SIZE][BOARD_SIZE], Move* move)
+/*
+ * Returns the castling rights lost when a piece moves from or to the square: the starting square of a king loses both
+ * castlings of its player, and the starting square of a rook the castling to its side.
+ */
+int getSquareCastlingRights(int square)
+{
+	switch (square)
+	{
+	case SQUARE_INDEX(0, KING_START_COLUMN):
+		return WHITE_KINGSIDE_CASTLING | WHITE_QUEENSIDE_CASTLING;
+	case SQUARE_INDEX(0, KINGSIDE_ROOK_COLUMN):
+		return WHITE_KINGSIDE_CASTLING;
+	case SQUARE_INDEX(0, QUEENSIDE_ROOK_COLUMN):
+		return WHITE_QUEENSIDE_CASTLING;
+	case SQUARE_INDEX(BOARD_SIZE - 1, KING_START_COLUMN):
+		return BLACK_KINGSIDE_CASTLING | BLACK_QUEENSIDE_CASTLING;
+	case SQUARE_INDEX(BOARD_SIZE - 1, KINGSIDE_ROOK_COLUMN):
+		return BLACK_KINGSIDE_CASTLING;
+	case SQUARE_INDEX(BOARD_SIZE - 1, QUEENSIDE_ROOK_COLUMN):
+		return BLACK_QUEENSIDE_CASTLING;
+	default:
+		return NO_CASTLING_RIGHTS;
+	}
+}
+
+/* Returns the castling rights the board allows: those whose king and rook are on their starting squares. */
+int getBoardCastlingRights(char board[BOARD_SIZE][BOARD_SIZE])
 {
-	GameStep* step = (GameStep*)malloc(sizeof(GameStep));
-	if (step == NULL)
+	int rights = NO_CASTLING_RIGHTS;
+	int player;
+	for (player = 0; player < NUM_OF_PLAYERS; player++)
 	{
-		printf("Error: standard function malloc has failed");
-		g_memError = true;
-		return NULL;
+		char* homeRow = board[HOME_ROW(player)];
+		if (homeRow[KING_START_COLUMN] != getSoldierChar(KING_TYPE, player))
+			continue;
+
+		if (homeRow[KINGSIDE_ROOK_COLUMN] == getSoldierChar(ROOK_TYPE, player))
+			rights |= KINGSIDE_CASTLING(player);
+		if (homeRow[QUEENSIDE_ROOK_COLUMN] == getSoldierChar(ROOK_TYPE, player))
+			rights |= QUEENSIDE_CASTLING(player);
 	}
 
-	bool isBlackPlayer = isSquareOccupiedByBlackPlayer(board, move->initPos.x, move->initPos.y);
+	return rights;
+}
+
+/*
+ * Set the castling rights of the game to those the board allows, and clear its en passant square.
+ * Called whenever the user sets up the game board.
+ */
+void initGameRights(char board[BOARD_SIZE][BOARD_SIZE])
+{
+	g_castlingRights = getBoardCastlingRights(board);
+	g_enPassantSquare = NO_EN_PASSANT_SQUARE;
+}
+
+/*
+ * Fill the game step struct with the changes the move makes to the board.
+ * The step is filled in place (no allocation), so the search can keep its steps in a preallocated stack.
+ */
+void initGameStep(char board[BOARD_SIZE][BOARD_SIZE], CompactMove move, GameStep* step)
+{
+	int startSquare = MOVE_START_SQUARE(move);
+	int targetSquare = MOVE_TARGET_SQUARE(move);
+	step->startPos.x = SQUARE_ROW(startSquare);
+	step->startPos.y = SQUARE_COLUMN(startSquare);
+	step->endPos.x = SQUARE_ROW(targetSquare);
+	step->endPos.y = SQUARE_COLUMN(targetSquare);
+
+	bool isBlackPlayer = isSquareOccupiedByBlackPlayer(board, step->startPos.x, step->startPos.y);
 	step->isStepByBlackPlayer = isBlackPlayer;
-	step->currSoldier = board[move->initPos.x][move->initPos.y];
-	step->startPos = move->initPos;
-	step->endPos = move->nextPos;
-	step->promotion = move->promotion; // Move contains promotion only if it happened for a pawn. We trust its validity here.
+	step->currSoldier = board[step->startPos.x][step->startPos.y];
+
+	// Move contains promotion only if it happened for a pawn. We trust its validity here.
+	PieceType promotionType = MOVE_PROMOTION_TYPE(move);
+	step->promotion = (promotionType == NO_PROMOTION_TYPE) ? EMPTY : getSoldierChar(promotionType, isBlackPlayer);
 
 	step->isEnemyRemovedInStep = false; // By default, set to false. Next we check if an eat happened and reset accordingly.
+	step->removedType = EMPTY;
+
+	// A king moving two squares castles, a pawn moving diagonally to a vacant square eats en passant
+	PieceType type = getPieceType(step->currSoldier);
+	int deltaY = step->endPos.y - step->startPos.y;
+	step->isCastling = ((type == KING_TYPE) && ((deltaY == CASTLING_KING_STEP) || (deltaY == -CASTLING_KING_STEP)));
+	step->isEnPassant = ((type == PAWN_TYPE) && (deltaY != 0) && (board[step->endPos.x][step->endPos.y] == EMPTY));
 
 	// Check if an enemy was eaten in this step
-	if (isSquareOccupiedByEnemy(board, isBlackPlayer, move->nextPos.x, move->nextPos.y))
+	if (isSquareOccupiedByEnemy(board, isBlackPlayer, step->endPos.x, step->endPos.y))
 	{
 		step->isEnemyRemovedInStep = true;
 
 		// Eaten soldier is located at where the current piece lands.
-		step->removedType = board[move->nextPos.x][move->nextPos.y];
+		step->removedType = board[step->endPos.x][step->endPos.y];
+	}
+	else if (step->isEnPassant)
+	{
+		step->isEnemyRemovedInStep = true;
+		step->removedType = getSoldierChar(PAWN_TYPE, !isBlackPlayer);
+	}
+
+	// Set by doStep
+	step->prevCastlingRights = NO_CASTLING_RIGHTS;
+	step->prevEnPassantSquare = NO_EN_PASSANT_SQUARE;
+}
+
+/* Returns the square of the enemy piece eaten in the step: its end square, or the square beside it en passant. */
+int getRemovedSquare(GameStep* step)
+{
+	if (step->isEnPassant)
+		return SQUARE_INDEX(step->startPos.x, step->endPos.y);
+
+	return SQUARE_INDEX(step->endPos.x, step->endPos.y);
+}
+
+/* Returns the columns the rook of a castling step moves from and to: its corner, and the square the king passes. */
+void getCastlingRookColumns(GameStep* step, int* startColumn, int* endColumn)
+{
+	*startColumn = (step->endPos.y > step->startPos.y) ? KINGSIDE_ROOK_COLUMN : QUEENSIDE_ROOK_COLUMN;
+	*endColumn = (step->startPos.y + step->endPos.y) / 2;
+}
+
+/* Returns the score of a piece of the given type. */
+int getPieceTypeScore(PieceType type)
+{
+	switch (type)
+	{
+	case PAWN_TYPE:
+		return PAWN_SCORE;
+	case KNIGHT_TYPE:
+		return KNIGHT_SCORE;
+	case BISHOP_TYPE:
+		return BISHOP_SCORE;
+	case ROOK_TYPE:
+		return ROOK_SCORE;
+	case QUEEN_TYPE:
+		return QUEEN_SCORE;
+	case KING_TYPE:
+		return KING_SCORE;
+	default:
+		return 0;
+	}
+}
+
+/* Computes the evaluation terms of the board state (material, piece-square table scores and phase) from scratch. */
+void computeEvaluationTerms(BoardState* state)
+{
+	int player;
+	for (player = 0; player < NUM_OF_PLAYERS; player++)
+	{
+		state->material[player] = 0;
+		state->midgame[player] = 0;
+		state->endgame[player] = 0;
+		state->phase[player] = 0;
+	}
+
+	int i, j; // i = row, j = column
+	for (i = 0; i < BOARD_SIZE; i++)
+	{
+		for (j = 0; j < BOARD_SIZE; j++)
+		{
+			char soldier = state->board[i][j];
+			if (soldier == EMPTY)
+				continue;
+
+			player = isBlackSoldier(soldier);
+			state->material[player] += getPieceTypeScore(getPieceType(soldier));
+			state->midgame[player] += PST_MIDGAME_SCORE(soldier, SQUARE_INDEX(i, j));
+			state->endgame[player] += PST_ENDGAME_SCORE(soldier, SQUARE_INDEX(i, j));
+			state->phase[player] += SOLDIER_PHASE(soldier);
+		}
+	}
+}
+
+/*
+ * Init the board state from the char board, the zobrist key and the evaluation terms (material, piece-square table
+ * scores and game phase) are computed from scratch.
+ */
+void initBoardState(BoardState* state, char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn)
+{
+	memcpy(state->board, board, sizeof(state->board));
+	state->isBlackTurn = isBlackTurn;
+	state->castlingRights = g_castlingRights;
+	state->enPassantSquare = g_enPassantSquare;
+	state->key = computeZobristKey(state->board, isBlackTurn, state->castlingRights, state->enPassantSquare);
+	computeEvaluationTerms(state);
+}
+
+/*
+ * Xor the keys of the squares changed by the step, and the turn key, into the zobrist key of the state.
+ * Xor is its own inverse, so the same update is used to do and to undo the step.
+ */
+void updateStepZobristKey(BoardState* state, GameStep* step)
+{
+	int startSquare = SQUARE_INDEX(step->startPos.x, step->startPos.y);
+	int endSquare = SQUARE_INDEX(step->endPos.x, step->endPos.y);
+	char endSoldier = (step->promotion != EMPTY) ? step->promotion : step->currSoldier;
+
+	state->key ^= ZOBRIST_SOLDIER_KEY(step->currSoldier, startSquare) ^ ZOBRIST_SOLDIER_KEY(endSoldier, endSquare);
+	if (step->isEnemyRemovedInStep)
+		state->key ^= ZOBRIST_SOLDIER_KEY(step->removedType, getRemovedSquare(step));
+
+	if (step->isCastling)
+	{
+		char rook = getSoldierChar(ROOK_TYPE, step->isStepByBlackPlayer);
+		int rookStartColumn, rookEndColumn;
+		getCastlingRookColumns(step, &rookStartColumn, &rookEndColumn);
+		state->key ^= ZOBRIST_SOLDIER_KEY(rook, SQUARE_INDEX(step->startPos.x, rookStartColumn))
+					  ^ ZOBRIST_SOLDIER_KEY(rook, SQUARE_INDEX(step->startPos.x, rookEndColumn));
 	}
 
-	return step;
+	state->key ^= g_zobristBlackTurnKey;
+}
+
+/* Set the castling rights and the en passant square of the state, the zobrist key is updated incrementally. */
+void setStateRights(BoardState* state, int castlingRights, int enPassantSquare)
+{
+	state->key ^= g_zobristCastlingKeys[state->castlingRights] ^ g_zobristCastlingKeys[castlingRights];
+	state->key ^= ZOBRIST_EN_PASSANT_KEY(state->enPassantSquare) ^ ZOBRIST_EN_PASSANT_KEY(enPassantSquare);
+	state->castlingRights = castlingRights;
+	state->enPassantSquare = enPassantSquare;
 }
 
-/* A destructor function for GameStep structs. */
-void deleteGameStep(GameStep* step)
+/*
+ * Returns the en passant square left by the step (done on the board of the state): the square a pawn pushed by two
+ * squares passed, if an enemy pawn stands beside it to eat it. Else NO_EN_PASSANT_SQUARE.
+ */
+int getStepEnPassantSquare(BoardState* state, GameStep* step)
 {
-	free(step);
+	int deltaX = step->endPos.x - step->startPos.x;
+	if ((getPieceType(step->currSoldier) != PAWN_TYPE) || ((deltaX != 2) && (deltaX != -2)))
+		return NO_EN_PASSANT_SQUARE;
+
+	char enemyPawn = getSoldierChar(PAWN_TYPE, !step->isStepByBlackPlayer);
+	int x = step->endPos.x;
+	int y = step->endPos.y;
+	if (((y > 0) && (state->board[x][y - 1] == enemyPawn)) ||
+		((y < BOARD_SIZE - 1) && (state->board[x][y + 1] == enemyPawn)))
+		return SQUARE_INDEX(step->startPos.x + (deltaX / 2), y);
+
+	return NO_EN_PASSANT_SQUARE;
 }
 
-/* Execute game step on the board. */
-void doStep(char board[BOARD_SIZE][BOARD_SIZE], GameStep* step)
+/*
+ * Add the changes of the step to the evaluation terms of the state (sign 1), or take them back (sign -1):
+ * the moving piece changes its square (and type, for a promotion) and the enemy piece eaten is removed.
+ */
+void updateStepEvaluationTerms(BoardState* state, GameStep* step, int sign)
+{
+	int player = step->isStepByBlackPlayer;
+	int startSquare = SQUARE_INDEX(step->startPos.x, step->startPos.y);
+	int endSquare = SQUARE_INDEX(step->endPos.x, step->endPos.y);
+	char endSoldier = (step->promotion != EMPTY) ? step->promotion : step->currSoldier;
+
+	state->midgame[player] += sign * (PST_MIDGAME_SCORE(endSoldier, endSquare)
+									  - PST_MIDGAME_SCORE(step->currSoldier, startSquare));
+	state->endgame[player] += sign * (PST_ENDGAME_SCORE(endSoldier, endSquare)
+									  - PST_ENDGAME_SCORE(step->currSoldier, startSquare));
+	if (step->promotion != EMPTY)
+	{
+		state->material[player] += sign * (getPieceTypeScore(getPieceType(step->promotion)) - PAWN_SCORE);
+		state->phase[player] += sign * SOLDIER_PHASE(step->promotion);
+	}
+
+	if (step->isEnemyRemovedInStep)
+	{
+		int removedSquare = getRemovedSquare(step);
+		state->material[!player] -= sign * getPieceTypeScore(getPieceType(step->removedType));
+		state->midgame[!player] -= sign * PST_MIDGAME_SCORE(step->removedType, removedSquare);
+		state->endgame[!player] -= sign * PST_ENDGAME_SCORE(step->removedType, removedSquare);
+		state->phase[!player] -= sign * SOLDIER_PHASE(step->removedType);
+	}
+
+	if (step->isCastling)
+	{
+		char rook = getSoldierChar(ROOK_TYPE, player);
+		int rookStartColumn, rookEndColumn;
+		getCastlingRookColumns(step, &rookStartColumn, &rookEndColumn);
+		int rookStartSquare = SQUARE_INDEX(step->startPos.x, rookStartColumn);
+		int rookEndSquare = SQUARE_INDEX(step->startPos.x, rookEndColumn);
+		state->midgame[player] += sign * (PST_MIDGAME_SCORE(rook, rookEndSquare) -
+										  PST_MIDGAME_SCORE(rook, rookStartSquare));
+		state->endgame[player] += sign * (PST_ENDGAME_SCORE(rook, rookEndSquare) -
+										  PST_ENDGAME_SCORE(rook, rookStartSquare));
+	}
+}
+
+#ifdef ZOBRIST_DEBUG
+/* Debug mode: compare the incremental zobrist key and evaluation terms of the state against a full computation. */
+void verifyZobristKey(BoardState* state, const char* caller)
+{
+	BoardState expected = *state;
+	expected.key = computeZobristKey(state->board, state->isBlackTurn, state->castlingRights, state->enPassantSquare);
+	computeEvaluationTerms(&expected);
+
+	if (state->key != expected.key)
+		printf("Debug: zobrist key mismatch after %s\n", caller);
+	if ((0 != memcmp(state->material, expected.material, sizeof(state->material)))
+		|| (0 != memcmp(state->midgame, expected.midgame, sizeof(state->midgame)))
+		|| (0 != memcmp(state->endgame, expected.endgame, sizeof(state->endgame)))
+		|| (0 != memcmp(state->phase, expected.phase, sizeof(state->phase))))
+		printf("Debug: evaluation terms mismatch after %s\n", caller);
+}
+#endif
+
+/*
+ * Execute game step on the board state, the zobrist key and the evaluation terms are updated incrementally.
+ * The castling rights and en passant square of the state are updated, and their previous values kept in the step.
+ */
+void doStep(BoardState* state, GameStep* step)
 {
 	// Remove start position
-	board[step->startPos.x][step->startPos.y] = EMPTY;
+	state->board[step->startPos.x][step->startPos.y] = EMPTY;
 
 	// Set end position to promotion / normal movement. This also removes an eaten enemy if there was any.
-	board[step->endPos.x][step->endPos.y] = (step->promotion != EMPTY) ? step->promotion : step->currSoldier;
+	state->board[step->endPos.x][step->endPos.y] = (step->promotion != EMPTY) ? step->promotion : step->currSoldier;
+
+	// The pawn eaten en passant is beside the end position
+	if (step->isEnPassant)
+		state->board[step->startPos.x][step->endPos.y] = EMPTY;
+
+	// The rook of a castling jumps over the king
+	if (step->isCastling)
+	{
+		int rookStartColumn, rookEndColumn;
+		getCastlingRookColumns(step, &rookStartColumn, &rookEndColumn);
+		state->board[step->startPos.x][rookEndColumn] = state->board[step->startPos.x][rookStartColumn];
+		state->board[step->startPos.x][rookStartColumn] = EMPTY;
+	}
+
+	updateStepZobristKey(state, step);
+	updateStepEvaluationTerms(state, step, 1);
+	state->isBlackTurn = !state->isBlackTurn;
+
+	// A king or rook leaving its starting square, or a rook eaten on it, ends the castlings it takes part in
+	int startSquare = SQUARE_INDEX(step->startPos.x, step->startPos.y);
+	int endSquare = SQUARE_INDEX(step->endPos.x, step->endPos.y);
+	step->prevCastlingRights = state->castlingRights;
+	step->prevEnPassantSquare = state->enPassantSquare;
+	int lostCastlingRights = getSquareCastlingRights(startSquare) | getSquareCastlingRights(endSquare);
+	setStateRights(state, state->castlingRights & ~lostCastlingRights, getStepEnPassantSquare(state, step));
+
+#ifdef ZOBRIST_DEBUG
+	verifyZobristKey(state, "doStep");
+#endif
 }
 
-/* Undo game step on the board. */
-void undoStep(char board[BOARD_SIZE][BOARD_SIZE], GameStep* step)
+/* Undo game step on the board state, the zobrist key and the evaluation terms are updated incrementally. */
+void undoStep(BoardState* state, GameStep* step)
 {
 	// Restore the original value of the target square (empty square for movement, eaten piece if there was an eat move).
-	board[step->endPos.x][step->endPos.y] = (step->isEnemyRemovedInStep) ? step->removedType : EMPTY;
+	state->board[step->endPos.x][step->endPos.y] = (step->isEnemyRemovedInStep) ? step->removedType : EMPTY;
 
 	// Set start position
 	if (EMPTY == step->promotion)
 	{ // Piece moved without promotion.
-		board[step->startPos.x][step->startPos.y] = step->currSoldier;
+		state->board[step->startPos.x][step->startPos.y] = step->currSoldier;
 	}
 	else
 	{ // Only pawns can get promoted, so the original square must have been a pawn. Check which color was it.
-		board[step->startPos.x][step->startPos.y] = step->isStepByBlackPlayer ? BLACK_P : WHITE_P;
+		state->board[step->startPos.x][step->startPos.y] = step->isStepByBlackPlayer ? BLACK_P : WHITE_P;
 	}
-	
+
+	// Restore the pawn eaten en passant beside the end position (the end position was vacant)
+	if (step->isEnPassant)
+	{
+		state->board[step->endPos.x][step->endPos.y] = EMPTY;
+		state->board[step->startPos.x][step->endPos.y] = step->removedType;
+	}
+
+	// Return the rook of a castling to its corner
+	if (step->isCastling)
+	{
+		int rookStartColumn, rookEndColumn;
+		getCastlingRookColumns(step, &rookStartColumn, &rookEndColumn);
+		state->board[step->startPos.x][rookStartColumn] = state->board[step->startPos.x][rookEndColumn];
+		state->board[step->startPos.x][rookEndColumn] = EMPTY;
+	}
+
+	updateStepZobristKey(state, step);
+	updateStepEvaluationTerms(state, step, -1);
+	state->isBlackTurn = !state->isBlackTurn;
+	setStateRights(state, step->prevCastlingRights, step->prevEnPassantSquare);
+
+#ifdef ZOBRIST_DEBUG
+	verifyZobristKey(state, "undoStep");
+#endif
+}
+
+/*
+ * Pass the turn to the other player without moving (a null move, only used by the search).
+ * The zobrist key is updated incrementally. The en passant square is cleared, and its previous value kept in the step.
+ */
+void doNullStep(BoardState* state, GameStep* step)
+{
+	state->key ^= g_zobristBlackTurnKey;
+	state->isBlackTurn = !state->isBlackTurn;
+
+	step->prevCastlingRights = state->castlingRights;
+	step->prevEnPassantSquare = state->enPassantSquare;
+	setStateRights(state, state->castlingRights, NO_EN_PASSANT_SQUARE);
+}
+
+/* Undo the null step done with doNullStep. */
+void undoNullStep(BoardState* state, GameStep* step)
+{
+	state->key ^= g_zobristBlackTurnKey;
+	state->isBlackTurn = !state->isBlackTurn;
+	setStateRights(state, step->prevCastlingRights, step->prevEnPassantSquare);
 }
 
 /* Returns if the square is on the board area. */
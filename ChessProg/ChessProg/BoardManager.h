@@ -3,6 +3,76 @@
 
 #include <stdio.h>
 #include "Types.h"
+#include "BitBoard.h"
+#include "Zobrist.h"
+#include "PieceSquareTables.h"
+
+/* Maximum number of moves a player may have in a single board state (the maximum known for chess is 218). */
+#define MAX_MOVES 256
+
+/* The material score of every piece type. Scores are in hundredths of a pawn, so positional terms can be finer. */
+#define PAWN_SCORE 100
+#define BISHOP_SCORE 300
+#define ROOK_SCORE 500
+#define KNIGHT_SCORE 300
+#define QUEEN_SCORE 900
+#define KING_SCORE 40000
+
+/*
+ * A compact encoding of a move, used by the engine so moves can be kept in fixed size buffers without allocations:
+ * bits 0-5 hold the start square, bits 6-11 hold the target square (see SQUARE_INDEX) and bits 12-15 hold the
+ * PieceType of the promotion. Pawns never promote to pawns, so PAWN_TYPE (0) marks moves without a promotion.
+ */
+typedef unsigned short CompactMove;
+
+#define NO_PROMOTION_TYPE PAWN_TYPE
+#define NUM_OF_PROMOTIONS 4	// A pawn reaching the edge promotes to a queen, rook, bishop or knight
+#define COMPACT_MOVE(startSquare, targetSquare, promotionType) \
+	((CompactMove)((startSquare) | ((targetSquare) << 6) | ((promotionType) << 12)))
+#define MOVE_START_SQUARE(move) ((move) & 0x3F)
+#define MOVE_TARGET_SQUARE(move) (((move) >> 6) & 0x3F)
+#define MOVE_PROMOTION_TYPE(move) ((PieceType)(((move) >> 12) & 0xF))
+#define NO_MOVE ((CompactMove)0)	// <a,1> to <a,1> is never a legal move
+
+/*
+ * Castling is encoded as a move of the king two squares towards the rook, from its starting square. The rook jumps
+ * to the square the king passes.
+ */
+#define KING_START_COLUMN 4
+#define KINGSIDE_ROOK_COLUMN (BOARD_SIZE - 1)
+#define QUEENSIDE_ROOK_COLUMN 0
+#define CASTLING_KING_STEP 2
+#define HOME_ROW(isBlack) ((isBlack) ? (BOARD_SIZE - 1) : 0)	// The row the king and rooks of the player start on
+#define PAWN_START_ROW(isBlack) ((isBlack) ? (BOARD_SIZE - 2) : 1)
+#define KINGSIDE_CASTLING(isBlack) ((isBlack) ? BLACK_KINGSIDE_CASTLING : WHITE_KINGSIDE_CASTLING)
+#define QUEENSIDE_CASTLING(isBlack) ((isBlack) ? BLACK_QUEENSIDE_CASTLING : WHITE_QUEENSIDE_CASTLING)
+
+/* The row of the en passant square a pawn of the black (isBlack == true) or white player can eat on. */
+#define EN_PASSANT_ROW(isBlack) ((isBlack) ? 2 : (BOARD_SIZE - 3))
+
+/* A fixed capacity buffer of moves. Callers usually keep it on the stack, so filling it never allocates memory. */
+typedef struct
+{
+	CompactMove moves[MAX_MOVES];
+	int length;
+} MoveBuffer;
+
+/*
+ * A game position as seen by the engine: the char board together with the player to move and the
+ * information the engine keeps up to date on every step (doStep / undoStep).
+ */
+typedef struct
+{
+	char board[BOARD_SIZE][BOARD_SIZE];	// The game board
+	bool isBlackTurn;					// True if the black player makes the next move
+	int castlingRights;					// Flags of the castlings the players may still do
+	int enPassantSquare;				// The square a pawn may be eaten en passant on, or NO_EN_PASSANT_SQUARE
+	ZobristKey key;						// The zobrist key of the position
+	int material[NUM_OF_PLAYERS];		// The sum of the scores of the pieces of each player
+	int midgame[NUM_OF_PLAYERS];		// The midgame piece-square table scores of the pieces of each player
+	int endgame[NUM_OF_PLAYERS];		// The endgame piece-square table scores of the pieces of each player
+	int phase[NUM_OF_PLAYERS];			// The game phase of the pieces of each player (see PieceSquareTables.h)
+} BoardState;
 
 /* Init the board with the pieces in the beginning of a game. */
 void init_board(char board[BOARD_SIZE][BOARD_SIZE]);
@@ -19,26 +89,72 @@ Position* createPosition();
 /* A constructor function for Move structs. */
 Move* createMove(Position* startPos, Position* targetPos);
 
+/* Returns the compact encoding of the move. */
+CompactMove encodeMove(const Move* move);
+
+/* Returns the Move struct of the compact move, done by the black (isBlackPlayer == true) or white player. */
+Move decodeMove(CompactMove compactMove, bool isBlackPlayer);
+
 /* A deep copy constructor function for Move structs. */
 Move* cloneMove(Move* original);
 
 /* A destructor function for Move structs */
 void deleteMove(void* move);
 
-/* Execute move on the board. In the end of this function the move is deleted. */
+/*
+ * Execute move on the game board, and update the castling rights and en passant square of the game.
+ * In the end of this function the move is deleted.
+ */
 bool executeMove(char board[BOARD_SIZE][BOARD_SIZE], Move* move);
 
-/* A constructor function for GameStep structs. */
-GameStep* createGameStep(char board[BOARD_SIZE][BOARD_SIZE], Move* move);
+/*
+ * Returns the castling rights lost when a piece moves from or to the square: the starting square of a king loses both
+ * castlings of its player, and the starting square of a rook the castling to its side.
+ */
+int getSquareCastlingRights(int square);
+
+/* Returns the castling rights the board allows: those whose king and rook are on their starting squares. */
+int getBoardCastlingRights(char board[BOARD_SIZE][BOARD_SIZE]);
 
-/* A destructor function for GameStep structs. */
-void deleteGameStep(GameStep* step);
+/*
+ * Set the castling rights of the game to those the board allows, and clear its en passant square.
+ * Called whenever the user sets up the game board.
+ */
+void initGameRights(char board[BOARD_SIZE][BOARD_SIZE]);
 
-/* Execute game step on the board. */
-void doStep(char board[BOARD_SIZE][BOARD_SIZE], GameStep* step);
+/*
+ * Fill the game step struct with the changes the move makes to the board.
+ * The step is filled in place (no allocation), so the search can keep its steps in a preallocated stack.
+ */
+void initGameStep(char board[BOARD_SIZE][BOARD_SIZE], CompactMove move, GameStep* step);
+
+/* Returns the score of a piece of the given type. */
+int getPieceTypeScore(PieceType type);
+
+/*
+ * Init the board state from the char board, the zobrist key and the evaluation terms (material, piece-square table
+ * scores and game phase) are computed from scratch. The castling rights and the en passant square are those of the
+ * game (g_castlingRights and g_enPassantSquare).
+ */
+void initBoardState(BoardState* state, char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn);
+
+/*
+ * Execute game step on the board state, the zobrist key and the evaluation terms are updated incrementally.
+ * The castling rights and en passant square of the state are updated, and their previous values kept in the step.
+ */
+void doStep(BoardState* state, GameStep* step);
+
+/* Undo game step on the board state, the zobrist key and the evaluation terms are updated incrementally. */
+void undoStep(BoardState* state, GameStep* step);
+
+/*
+ * Pass the turn to the other player without moving (a null move, only used by the search).
+ * The zobrist key is updated incrementally. The en passant square is cleared, and its previous value kept in the step.
+ */
+void doNullStep(BoardState* state, GameStep* step);
 
-/* Undo game step on the board. */
-void undoStep(char board[BOARD_SIZE][BOARD_SIZE], GameStep* step);
+/* Undo the null step done with doNullStep. */
+void undoNullStep(BoardState* state, GameStep* step);
 
 /*
  * Returns the size of the army of the black / white player (according to the input isBlackSoldiers parameter).
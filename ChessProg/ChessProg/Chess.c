@@ -4,6 +4,8 @@
 #include "Types.h"
 #include "Console.h"
 #include "ChessMainWindow.h"
+#include "TranspositionTable.h"
+#include "BitBoard.h"
 
 int main(int argc, char *argv[])
 {
@@ -26,14 +28,18 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	initAttackTables(); // Before any move is generated
+
+	int exitCode;
 	if (!isGuiMode)
 	{
-		return initConsoleMainLoop();
+		exitCode = initConsoleMainLoop();
 	}
 	else
 	{
-		return runGuiMainLoop();
+		exitCode = runGuiMainLoop();
 	}
 
-	return 0;
+	freeTranspositionTable();
+	return exitCode;
 }
\ No newline at end of file
@@ -31,6 +31,10 @@
 #define RESOURCE_IMG_EXT ".bmp"
 #define MINMAX_DEPTH_IMG_PATH "Resources/button_depth" // Image of "Depth #" button
 #define MINMAX_BEST_DEPTH_IMG_PATH "Resources/button_depthbest.bmp" // Image of "BEST DEPTH" button
+#define FONT_IMG "Resources/font.bmp" // Glyphs of the font of labels, in the order of FONT_CHARACTERS
+#define FONT_CHARACTERS "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+-:/.,%=()"
+#define FONT_GLYPH_W 12 // Dimensions for a single glyph of the font
+#define FONT_GLYPH_H 16
 
 #define NUM_OF_SLOT_DIGITS_SUPPORTED 2 // Number of digits we support for slots in dialogs.
 									   // (no point raising this above 2, there's no room on screen)
@@ -1,6 +1,7 @@
 #include "ChessGuiGameWindow.h"
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 #include "ChessGuiCommons.h"
 #include "ChessGuiGameControl.h"
 #include "GameCommands.h"
@@ -20,6 +21,13 @@
 #define SAVE_BUTTON_OFFSET_Y 100
 #define MENU_BUTTON_OFFSET_Y 163
 #define QUIT_BUTTON_OFFSET_Y 350
+#define SEARCH_INFO_OFFSET_Y 212 // Position of the search info panel, between the menu and quit buttons
+#define SEARCH_INFO_OFFSET_X 5
+#define SEARCH_INFO_W 150
+#define SEARCH_INFO_H 134
+#define SEARCH_INFO_MARGIN 3 // Margin of the text inside the search info panel
+#define SEARCH_INFO_MOVES_PER_LINE 2 // Moves of the principal variation shown in each line
+#define SEARCH_INFO_LENGTH 128 // Maximum length of the search info text
 
 /** Resources paths */
 #define BUTTON_BESTMOVE_IMG "Resources/button_bestmove.bmp"
@@ -36,6 +44,9 @@
 #define MSG_SAVE_FAILED_W 320
 #define MSG_SAVE_FAILED_H 40
 
+/** Background color of the search info panel, matching the buttons */
+const GuiColorRGB SEARCH_INFO_BG = { 20, 14, 110 };
+
 /** Information attached to the game window, to provide info in events.
 */
 struct GameWindowExtent
@@ -47,6 +58,7 @@ struct GameWindowExtent
 	GuiImage* mateWhiteWinsImg;
 	GuiImage* tieImg;
 	GuiButton* bestMoveButton;
+	GuiLabel* searchInfoLabel;
 	GameControl* gameControl;
 };
 typedef struct GameWindowExtent GameWindowExtent;
@@ -193,6 +205,32 @@ char showPromotionDialog(GuiWindow* window, bool isBlackPlayer)
 	return promotion;
 }
 
+/** Sets the piece of every gui square to the piece on its square in the logic layer.
+ *  Castlings and en passant captures change squares other than the source and target of the move.
+ */
+void syncGuiBoard(GameControl* gameControl)
+{
+	int i, j;
+	for (i = 0; i < BOARD_SIZE; i++)
+	{
+		for (j = 0; j < BOARD_SIZE; j++)
+		{
+			GameSquare* square = &(gameControl->gui_board[boardRowIndexToGuiRowIndex(i)][j]);
+			GuiImage* pieceImg = getImageForChessPiece(gameControl, gameControl->board[i][j]);
+			if (NULL == pieceImg)
+			{
+				square->chessPiece->bgImage = NULL;
+				square->chessPiece->generalProperties.isVisible = false;
+			}
+			else if (square->chessPiece->bgImage != pieceImg)
+			{
+				square->chessPiece->setBGImage(square->chessPiece, pieceImg);
+				square->chessPiece->generalProperties.isVisible = true;
+			}
+		}
+	}
+}
+
 /** Refresh and update the gui board after a move has been executed. */
 void updateGuiAfterMove(GameControl* gameControl, char promotion, GameSquare* source, GameSquare* target)
 {
@@ -207,6 +245,7 @@ void updateGuiAfterMove(GameControl* gameControl, char promotion, GameSquare* so
 	target->chessPiece->generalProperties.isVisible = true;
 	source->chessPiece->bgImage = NULL;
 	source->chessPiece->generalProperties.isVisible = false;
+	syncGuiBoard(gameControl);
 	refreshBoard(gameControl);
 }
 
@@ -308,6 +347,70 @@ bool executeGuiTurn(GuiWindow* window, GameControl* gameControl, Move* move)
 	return isGameOver;
 }
 
+/** Appends the short form of a count (e.g: 196K for 196657) to the text. */
+void appendCount(char* text, unsigned long long count)
+{
+	char* end = text + strlen(text);
+	if (count < 100000)
+		sprintf(end, "%llu", count);
+	else if (count < 100000000)
+		sprintf(end, "%lluK", count / 1000);
+	else
+		sprintf(end, "%lluM", count / 1000000);
+}
+
+/** Appends the separator and the short form of a move (e.g: a7a8q) to the text. */
+void appendMove(char* text, char separator, const Move* move)
+{
+	char* end = text + strlen(text);
+	*(end++) = separator;
+	*(end++) = 'a' + move->initPos.y;
+	*(end++) = '1' + move->initPos.x;
+	*(end++) = 'a' + move->nextPos.y;
+	*(end++) = '1' + move->nextPos.x;
+	if (EMPTY != move->promotion)
+		*(end++) = tolower(move->promotion);
+	*end = '\0';
+}
+
+/** Shows the result of the last search in the side panel: its depth, boards and speed, then the score and principal
+ *	variation of the search, or the score of every top move if it was a multi-PV search. The moves found are moves of
+ *	the player isBlackPlayer.
+ */
+void showSearchInfo(GuiWindow* window, const SearchInfo* info, bool isBlackPlayer)
+{
+	GameWindowExtent* windowExtent = (GameWindowExtent*)window->generalProperties.extent;
+	char text[SEARCH_INFO_LENGTH];
+	int i;
+
+	sprintf(text, "DEPTH %d\nBOARDS ", info->depth);
+	appendCount(text, info->nodes);
+	strcat(text, "\nSPEED ");
+	appendCount(text, (info->nodes * 1000) / (unsigned long long)maxi(1, (int)info->timeInMs));
+	strcat(text, "/S");
+
+	if (info->numOfLines > 0)
+	{	// A line for every top move with its score, as long as they fit in the text
+		for (i = 0; (i < info->numOfLines) && (strlen(text) + 16 < SEARCH_INFO_LENGTH); i++)
+		{
+			Move move = decodeMove(info->lines[i].moves[0], isBlackPlayer);
+			appendMove(text, '\n', &move);
+			sprintf(text + strlen(text), " %+d", info->lines[i].value);
+		}
+	}
+	else
+	{	// The moves of the principal variation, as long as they fit in the text
+		sprintf(text + strlen(text), "\nSCORE %+d", info->score);
+		for (i = 0; (i < info->length) && (strlen(text) + 8 < SEARCH_INFO_LENGTH); i++)
+		{
+			Move move = decodeMove(info->moves[i], ((i % 2) == 0) ? isBlackPlayer : !isBlackPlayer);
+			appendMove(text, ((i % SEARCH_INFO_MOVES_PER_LINE) == 0) ? '\n' : ' ', &move);
+		}
+	}
+
+	windowExtent->searchInfoLabel->setText(windowExtent->searchInfoLabel, text);
+}
+
 /** Executes the next turn by the computer. */
 void executeGuiNextComputerMove(GuiWindow* gameWindow)
 {
@@ -315,13 +418,17 @@ void executeGuiNextComputerMove(GuiWindow* gameWindow)
 	GameControl* gameControl = windowExtent->gameControl;
 
 	gui_delay(AI_THINKING_FREEZE_TIME); // Wait minimal amount of time for computer turn
-	Move* nextComputerMove = executeGetNextComputerMoveCommand(gameControl->board, g_isUserBlack);
+	SearchContext context;
+	initCommandSearchContext(&context, g_isDifficultyBest ? DIFFICULTY_BEST_INT : g_minimaxDepth);
+	Move* nextComputerMove = executeGetNextComputerMoveCommand(&context, gameControl->board, g_isUserBlack);
 	if (NULL == nextComputerMove)
 	{
 		g_guiError = true;
 		return;
 	}
 
+	showSearchInfo(gameWindow, &(context.info), !g_isUserBlack);
+
 	// Execute the move and update the gui
 	executeGuiTurn(gameWindow, gameControl, nextComputerMove);
 }
@@ -392,7 +499,9 @@ void onTargetClick(GuiButton* button)
 //  -- Side Panel Logic functions --
 //  --------------------------------
 
-/** Marks the best move available on board. This event is prompted when the best move button is clicked. */
+/** Marks the best move available on board and shows the line expected to follow it in the side panel.
+ *	This event is prompted when the best move button is clicked.
+ */
 void onBestMoveClick(GuiButton* button)
 {
 	GuiWindow* window = button->generalProperties.window;
@@ -403,7 +512,7 @@ void onBestMoveClick(GuiButton* button)
 	// For AI we use the configured min max depth
 	if (g_gameMode == GAME_MODE_PLAYER_VS_AI)
 	{
-		depth = g_minimaxDepth;
+		depth = g_isDifficultyBest ? DIFFICULTY_BEST_INT : g_minimaxDepth;
 	}
 	else
 	{ // For player vs player we show a dialog and let the player choose
@@ -417,14 +526,24 @@ void onBestMoveClick(GuiButton* button)
 			return; // On error or cancel - return
 	}
 
-	LinkedList* bestMoves = executeGetBestMovesCommand(gameControl->board, gameControl->isBlackPlayerEditable, depth);
-	if ((g_guiError) || (g_memError) || (bestMoves == NULL))
+	SearchContext context;
+	initCommandSearchContext(&context, depth);
+	LinkedList* topMoves = executeGetTopMovesCommand(&context, gameControl->board,
+													 gameControl->isBlackPlayerEditable, g_multiPv);
+	if ((g_guiError) || (g_memError) || (context.isError) || (topMoves == NULL))
 	{
 		return;
 	}
+	if (NULL == topMoves->head)
+	{ // No moves to show
+		deleteList(topMoves);
+		return;
+	}
+
+	showSearchInfo(window, &(context.info), gameControl->isBlackPlayerEditable);
 
-	// We only show one best move
-	Move* move = (Move*)bestMoves->head->data;
+	// We only mark the best move, the others are listed with their scores in the side panel
+	Move* move = (Move*)topMoves->head->data;
 	int guiStartX = boardRowIndexToGuiRowIndex(move->initPos.x);
 	int guiStartY = move->initPos.y;
 	int guiTargetX = boardRowIndexToGuiRowIndex(move->nextPos.x);
@@ -437,7 +556,7 @@ void onBestMoveClick(GuiButton* button)
 	gameControl->gui_board[guiStartX][guiStartY].targetButton->generalProperties.isVisible = true;
 	gameControl->gui_board[guiTargetX][guiTargetY].targetButton->generalProperties.isVisible = true;
 
-	deleteList(bestMoves);
+	deleteList(topMoves);
 }
 
 /** Open the save game to slots dialog. This event is prompted when the save button is clicked. */
@@ -524,7 +643,7 @@ void destroyGameWindow(void* component)
  *	access to components).
  */
 GameWindowExtent* createGameWindowExtent(GuiWindow* gameWindow, GuiPanel* gameAreaPanel, GuiButton* bestButton,
-										 char board[BOARD_SIZE][BOARD_SIZE])
+										 GuiLabel* searchInfoLabel, char board[BOARD_SIZE][BOARD_SIZE])
 {
 	GameWindowExtent* gameWindowExtent = (GameWindowExtent*)malloc(sizeof(GameWindowExtent));
 	if (NULL == gameWindowExtent)
@@ -596,6 +715,7 @@ GameWindowExtent* createGameWindowExtent(GuiWindow* gameWindow, GuiPanel* gameAr
 	gameWindowExtent->mateWhiteWinsImg = mateWhiteWinsImg;
 	gameWindowExtent->tieImg = tieImg;
 	gameWindowExtent->bestMoveButton = bestButton;
+	gameWindowExtent->searchInfoLabel = searchInfoLabel;
 
 	return gameWindowExtent;
 }
@@ -615,6 +735,7 @@ GuiWindow* createGameWindow(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack
 	short saveButtonZIndex = 1;
 	short menuButtonZIndex = 2;
 	short quitButtonZIndex = 3;
+	short searchInfoZIndex = 4;
 
 	GuiColorRGB bgcolor = WHITE;
 	GuiWindow* gameWindow = createWindow(WIN_W, WIN_H, GAME_WINDOW_TITLE, bgcolor);
@@ -682,6 +803,26 @@ GuiWindow* createGameWindow(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack
 		return NULL;
 	}
 
+	// The search info panel, with the text on top of it
+	Rectangle searchInfoBounds = { SEARCH_INFO_OFFSET_X, SEARCH_INFO_OFFSET_Y, SEARCH_INFO_W, SEARCH_INFO_H };
+	GuiPanel* searchInfoPanel = createPanel(sidePanel->generalProperties.wrapper, searchInfoBounds,
+		searchInfoZIndex, SEARCH_INFO_BG);
+	if ((NULL == searchInfoPanel) || g_guiError)
+	{ // Clean on errors
+		destroyWindow(gameWindow);
+		return NULL;
+	}
+
+	Rectangle searchInfoTextBounds = { SEARCH_INFO_MARGIN, SEARCH_INFO_MARGIN,
+		SEARCH_INFO_W - (SEARCH_INFO_MARGIN * 2), SEARCH_INFO_H - (SEARCH_INFO_MARGIN * 2) };
+	GuiLabel* searchInfoLabel = createLabel(searchInfoPanel->generalProperties.wrapper, searchInfoTextBounds,
+		0, FONT_IMG, MAGENTA, FONT_CHARACTERS, FONT_GLYPH_W, FONT_GLYPH_H);
+	if ((NULL == searchInfoLabel) || g_guiError)
+	{ // Clean on errors
+		destroyWindow(gameWindow);
+		return NULL;
+	}
+
 	Rectangle gameAreaBounds = { 0, 0, BOARD_W, BOARD_H };
 	GuiPanel* gameAreaPanel = createPanel(gameWindow->generalProperties.wrapper, gameAreaBounds, gameAreaPanelZIndex, GRAY);
 	if ((NULL == gameAreaPanel) || g_guiError)
@@ -691,7 +832,7 @@ GuiWindow* createGameWindow(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack
 	}
 
 	// Create the game window extent
-	GameWindowExtent* windowExtent = createGameWindowExtent(gameWindow, gameAreaPanel, bestMoveBtn, board);
+	GameWindowExtent* windowExtent = createGameWindowExtent(gameWindow, gameAreaPanel, bestMoveBtn, searchInfoLabel, board);
 	if (NULL == windowExtent)
 	{
 		gameWindow->generalProperties.destroy(gameWindow);
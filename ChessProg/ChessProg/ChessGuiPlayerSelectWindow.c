@@ -5,6 +5,7 @@
 #include "ChessGuiGameWindow.h"
 #include "ChessGuiAISettingsWindow.h"
 #include "GameCommands.h"
+#include "BoardManager.h"
 
 //  -------------------------------- 
 //  -- Constants and type defs    --
@@ -222,6 +223,7 @@ void showChessPiecesDialog(GuiWindow* window, GameSquare* targetGameSquare)
 	int logicX = guiRowIndexToboardRowIndex(targetGameSquare->x);
 	int logicY = targetGameSquare->y;
 	extent->gameControl->board[logicX][logicY] = piece;
+	initGameRights(extent->gameControl->board);
 }
 
 /** When a chess piece is clicked, this event is prompted (it is attached to every chess piece button's onClick).
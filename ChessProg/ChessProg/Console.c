@@ -6,6 +6,9 @@
 #include "BoardManager.h"
 #include "GameCommands.h"
 #include "LinkedList.h"
+#include "TranspositionTable.h"
+#include "Benchmark.h"
+#include "ParallelSearch.h"
 
 /** -- Console constants -- */
 // (these constants are private to the console so they are declared here)
@@ -29,10 +32,27 @@
 #define QUIT_COMMAND "quit"
 #define START_COMMAND "start"
 #define MOVE_COMMAND "move"
+#define CASTLE_COMMAND "castle"
 #define GET_MOVES_COMMAND "get_moves"
 #define GET_BEST_MOVES_COMMAND "get_best_moves"
 #define GET_SCORE_COMMAND "get_score"
+#define GET_PV_COMMAND "get_pv"
+#define GET_TOP_MOVES_COMMAND "get_top_moves"
 #define SAVE_COMMAND "save"
+#define TT_SIZE_COMMAND "tt_size"
+#define TT_STATS_COMMAND "tt_stats"
+#define TIME_LIMIT_COMMAND "time_limit"
+#define NODE_LIMIT_COMMAND "node_limit"
+#define BENCH_COMMAND "bench"
+#define THREADS_COMMAND "threads"
+#define PARALLEL_MODE_COMMAND "parallel_mode"
+#define QUIESCENCE_COMMAND "quiescence"
+#define NULL_MOVE_COMMAND "null_move"
+#define LMR_COMMAND "lmr"
+#define EVALUATOR_COMMAND "evaluator"
+#define MULTI_PV_COMMAND "multi_pv"
+#define SETTING_ON "on"
+#define SETTING_OFF "off"
 
 #define WELCOME_TO_CHESS "Welcome to Chess!\n\n"
 #define ENTER_SETTINGS "Enter game settings:\n" 
@@ -49,6 +69,9 @@
 #define WRONG_ROOK_POSITION "Wrong position for a rook\n" 
 #define ILLEGAL_CASTLING_MOVE "Illegal castling move\n"  
 
+#define TT_STATS "Transposition table: %d MB, hits: %llu, misses: %llu, overwrites: %llu\n"
+#define SEARCH_INFO "Depth %d, score %d, boards %llu (%llu quiescence), %lld ms, %llu boards per second\n"
+#define TOP_MOVE "%d. score %d: "
 #define CHECK "Check!\n"
 #define TIE "The game ends in a tie\n"
 #define WIN_MSG "Mate! %s player wins the game\n"
@@ -278,6 +301,59 @@ Move* parseAndBuildMove(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, ch
 	return move;
 }
 
+/*
+* Parses and builds the king "Move" struct of a castling with the rook in the position of args[1].
+* The castling will also be validated. If it is illegal, NULL is returned.
+* If the function succeeds and this is a valid castling, the move of the king is returned.
+*/
+Move* parseAndBuildCastlingMove(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, char* args[])
+{
+	Position rookPos = argToPosition(args[1]);
+
+	// Validation #1 - Invalid position
+	if (!isSquareOnBoard(rookPos.x, rookPos.y))
+	{
+		printf(WRONG_POSITION);
+		return NULL;
+	}
+
+	// Validation #2 - Not a rook of the player
+	if (board[rookPos.x][rookPos.y] != (isUserBlack ? BLACK_R : WHITE_R))
+	{
+		printf(WRONG_ROOK_POSITION);
+		return NULL;
+	}
+
+	// Validation #3 - The rook and the king are not on their starting squares
+	int homeRow = HOME_ROW(isUserBlack);
+	if ((rookPos.x != homeRow) || ((rookPos.y != KINGSIDE_ROOK_COLUMN) && (rookPos.y != QUEENSIDE_ROOK_COLUMN)) ||
+		(board[homeRow][KING_START_COLUMN] != (isUserBlack ? BLACK_K : WHITE_K)))
+	{
+		printf(ILLEGAL_CASTLING_MOVE);
+		return NULL;
+	}
+
+	// Build the move of the king towards the rook
+	Position kingPos = { homeRow, KING_START_COLUMN };
+	Position nextPos = { homeRow, KING_START_COLUMN };
+	nextPos.y += (rookPos.y == KINGSIDE_ROOK_COLUMN) ? CASTLING_KING_STEP : -CASTLING_KING_STEP;
+	Move* move = createMove(&kingPos, &nextPos);
+	if (g_memError)
+		return NULL;
+
+	// Validation #4 - Is the castling legal (the rights, the squares between them and the attacked squares)
+	if (!validateMove(board, isUserBlack, move))
+	{
+		if (!g_memError)
+			printf(ILLEGAL_CASTLING_MOVE); // False may return on mem errors too so query the global mem error flag
+
+		deleteMove((void*)move);
+		return NULL;
+	}
+
+	return move;
+}
+
 /*
  * Parse next user setting during Settings state and execute it.
  * Return RETRY if the settings haven't done, QUIT if a quit command was entered
@@ -367,6 +443,7 @@ COMMAND_RESULT parseUserSettings(char board[BOARD_SIZE][BOARD_SIZE])
 		else if (0 == strcmp(CLEAR_COMMAND, args[0]))
 		{	// Clear
 			clearBoard(board);
+			initGameRights(board);
 
 			commandResult = RETRY;
 		}
@@ -384,9 +461,14 @@ COMMAND_RESULT parseUserSettings(char board[BOARD_SIZE][BOARD_SIZE])
 			Position pos = argToPosition(args[1]);
 			// Validate position
 			if (isSquareOnBoard(pos.x, pos.y))
+			{
 				board[pos.x][pos.y] = EMPTY;
+				initGameRights(board);
+			}
 			else
+			{
 				printf(WRONG_POSITION);
+			}
 
 			commandResult = RETRY;
 		}
@@ -490,6 +572,8 @@ COMMAND_RESULT parseUserSettings(char board[BOARD_SIZE][BOARD_SIZE])
 							printf(WRONG_SET);
 					}
 				}
+
+				initGameRights(board);
 			}
 			else
 			{
@@ -498,6 +582,127 @@ COMMAND_RESULT parseUserSettings(char board[BOARD_SIZE][BOARD_SIZE])
 
 			commandResult = RETRY;
 		}
+		else if (0 == strcmp(TT_SIZE_COMMAND, args[0]))
+		{	// Transposition table size (in MB)
+			int sizeInMB = (argc > 1) ? atoi(args[1]) : 0;
+			if ((sizeInMB >= 1) && (sizeInMB <= TT_MAX_SIZE_MB))
+			{
+				if (!setTranspositionTableSize(sizeInMB))
+				{
+					g_memError = true;
+					commandResult = QUIT;
+				}
+			}
+			else	// Illegal size
+				printf(WRONG_TT_SIZE);
+		}
+		else if (0 == strcmp(TIME_LIMIT_COMMAND, args[0]))
+		{	// Time limit of a single search (in milliseconds, 0 for no limit)
+			int timeLimit = (argc > 1) ? atoi(args[1]) : -1;
+			if (timeLimit >= 0)
+				g_searchTimeLimit = timeLimit;
+			else	// Illegal time limit
+				printf(WRONG_TIME_LIMIT);
+		}
+		else if (0 == strcmp(NODE_LIMIT_COMMAND, args[0]))
+		{	// Boards limit of a single search (0 for no limit)
+			int nodeLimit = (argc > 1) ? atoi(args[1]) : -1;
+			if (nodeLimit >= 0)
+				g_searchNodeLimit = nodeLimit;
+			else	// Illegal boards limit
+				printf(WRONG_NODE_LIMIT);
+		}
+		else if (0 == strcmp(THREADS_COMMAND, args[0]))
+		{	// Number of threads searching the computer moves
+			int numOfThreads = (argc > 1) ? atoi(args[1]) : 0;
+			if ((numOfThreads >= 1) && (numOfThreads <= MAX_SEARCH_THREADS))
+				setNumOfSearchThreads(numOfThreads);
+			else	// Illegal number of threads
+				printf(WRONG_NUM_OF_THREADS);
+		}
+		else if (0 == strcmp(PARALLEL_MODE_COMMAND, args[0]))
+		{	// How the search threads share the work
+			if ((argc > 1) && (0 == strcmp(ROOT_SPLIT_MODE, args[1])))
+				setParallelMode(PARALLEL_ROOT_SPLIT);
+			else if ((argc > 1) && (0 == strcmp(LAZY_SMP_MODE, args[1])))
+				setParallelMode(PARALLEL_LAZY_SMP);
+			else	// Illegal mode
+				printf(WRONG_PARALLEL_MODE);
+		}
+		else if (0 == strcmp(QUIESCENCE_COMMAND, args[0]))
+		{	// Quiescence search at the leaves of the search
+			if ((argc > 1) && ((0 == strcmp(SETTING_ON, args[1])) || (0 == strcmp(SETTING_OFF, args[1]))))
+			{
+				g_isQuiescence = (0 == strcmp(SETTING_ON, args[1]));
+				clearTranspositionTable();	// The stored scores are of the other search
+			}
+			else	// Illegal value
+				printf(WRONG_QUIESCENCE);
+		}
+		else if (0 == strcmp(NULL_MOVE_COMMAND, args[0]))
+		{	// Null move pruning
+			if ((argc > 1) && ((0 == strcmp(SETTING_ON, args[1])) || (0 == strcmp(SETTING_OFF, args[1]))))
+			{
+				bool isOn = (0 == strcmp(SETTING_ON, args[1]));
+				if (g_isNullMovePruning != isOn)
+					clearTranspositionTable();	// The stored scores are of the other search
+				g_isNullMovePruning = isOn;
+			}
+			else	// Illegal value
+				printf(WRONG_NULL_MOVE);
+		}
+		else if (0 == strcmp(LMR_COMMAND, args[0]))
+		{	// Late move reductions
+			if ((argc > 1) && ((0 == strcmp(SETTING_ON, args[1])) || (0 == strcmp(SETTING_OFF, args[1]))))
+			{
+				bool isOn = (0 == strcmp(SETTING_ON, args[1]));
+				if (g_isLateMoveReduction != isOn)
+					clearTranspositionTable();	// The stored scores are of the other search
+				g_isLateMoveReduction = isOn;
+			}
+			else	// Illegal value
+				printf(WRONG_LMR);
+		}
+		else if (0 == strcmp(EVALUATOR_COMMAND, args[0]))
+		{	// The evaluator scoring the leaves of the search: material, pst or full
+			EvaluatorType evaluatorType = (argc > 1) ? getEvaluatorTypeByName(args[1]) : NUM_OF_EVALUATORS;
+			if (evaluatorType != NUM_OF_EVALUATORS)
+			{
+				setEvaluatorType(evaluatorType);
+				clearTranspositionTable();	// The stored scores are of the other evaluator
+			}
+			else	// Illegal evaluator
+				printf(WRONG_EVALUATOR);
+		}
+		else if (0 == strcmp(MULTI_PV_COMMAND, args[0]))
+		{	// Number of best moves ranked by get_top_moves and the best move button
+			int multiPv = (argc > 1) ? atoi(args[1]) : 0;
+			if ((multiPv >= 1) && (multiPv <= MAX_MULTI_PV))
+				g_multiPv = multiPv;
+			else	// Illegal number of moves
+				printf(WRONG_MULTI_PV);
+		}
+		else if (0 == strcmp(BENCH_COMMAND, args[0]))
+		{	// Benchmark the search, evaluators or move generation of the current board: bench <name> <depth>
+			int depth = (argc > 2) ? atoi(args[2]) : 0;
+			if ((argc < 2) || (!isBenchmarkName(args[1])))
+				printf(WRONG_BENCHMARK);
+			else if ((depth < 1) || (depth > MAX_DEPTH))
+				printf(WRONG_MINIMAX_DEPTH);
+			else if (0 == strcmp(BENCH_EVALUATION, args[1]))
+				runEvaluationBenchmark(board, g_isNextPlayerBlack, depth);
+			else if (0 == strcmp(BENCH_MOVE_GENERATION, args[1]))
+				runMoveGenerationBenchmark(board, g_isNextPlayerBlack, depth);
+			else if (0 == strcmp(BENCH_SLIDING_ATTACKS, args[1]))
+				runSlidingAttacksBenchmark(board, g_isNextPlayerBlack, depth);
+			else if (0 == strcmp(BENCH_PERFT, args[1]))
+				runPerftBenchmark(board, g_isNextPlayerBlack, depth);
+			else
+				runSearchBenchmark(board, g_isNextPlayerBlack, depth, args[1]);
+
+			if (g_memError)
+				commandResult = QUIT;
+		}
 		else if (0 == strcmp(PRINT_COMMAND, args[0]))
 		{	// Print
 			print_board(board);
@@ -600,6 +805,18 @@ COMMAND_RESULT parseUserCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserB
 			else
 				commandResult = SUCCESS;
 		}
+		else if (0 == strcmp(CASTLE_COMMAND, args[0]))
+		{	// Castle with the rook in the given position
+			Move* move = parseAndBuildCastlingMove(board, isUserBlack, args);
+			bool isMoveExecuted = executeMoveCommand(board, move);
+			if (g_memError)
+				return QUIT;
+
+			if (!isMoveExecuted)	// Illegal command
+				commandResult = RETRY;
+			else
+				commandResult = SUCCESS;
+		}
 		else if (0 == strcmp(GET_MOVES_COMMAND, args[0]))
 		{	// Get Moves
 			Position pos = argToPosition(args[1]);
@@ -623,8 +840,10 @@ COMMAND_RESULT parseUserCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserB
 			else
 				depth = atoi(args[1]);
 
-			LinkedList* bestMoves = executeGetBestMovesCommand(board, isUserBlack, depth);
-			if (g_memError)
+			SearchContext context;
+			initCommandSearchContext(&context, depth);
+			LinkedList* bestMoves = executeGetBestMovesCommand(&context, board, isUserBlack);
+			if (g_memError || context.isError)
 				return QUIT;
 
 			printListOfMoves(bestMoves);
@@ -645,9 +864,14 @@ COMMAND_RESULT parseUserCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserB
 				else
 					depth = atoi(args[1]);
 
-				int score = executeGetScoreCommand(board, isUserBlack, depth, move);
-				if (g_memError)
+				SearchContext context;
+				initCommandSearchContext(&context, depth);
+				int score = executeGetScoreCommand(&context, board, isUserBlack, move);
+				if (context.isError)
+				{
+					deleteMove((void*)move);
 					return QUIT;
+				}
 
 				printf("%d\n", score);
 
@@ -656,6 +880,86 @@ COMMAND_RESULT parseUserCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserB
 
 			commandResult = RETRY;
 		}
+		else if (0 == strcmp(GET_PV_COMMAND, args[0]))
+		{	// Get the principal variation, by default searched as a computer move of the game's difficulty
+			int depth = g_isDifficultyBest ? DIFFICULTY_BEST_INT : g_minimaxDepth;
+			if (argc > 1)
+			{
+				if (0 == strcmp(args[1], DIFFICULTY_BEST))
+					depth = DIFFICULTY_BEST_INT;
+				else
+					depth = atoi(args[1]);
+			}
+
+			if ((depth != DIFFICULTY_BEST_INT) && ((depth < 1) || (depth > MAX_DEPTH)))
+				printf(WRONG_MINIMAX_DEPTH);
+			else
+			{
+				SearchContext context;
+				initCommandSearchContext(&context, depth);
+				LinkedList* pvMoves = executeGetPrincipalVariationCommand(&context, board, isUserBlack);
+				if (g_memError || context.isError)
+					return QUIT;
+
+				SearchInfo* info = &(context.info);
+				unsigned long long boardsPerSecond =
+					(info->nodes * 1000) / (unsigned long long)maxi(1, (int)info->timeInMs);
+				printf(SEARCH_INFO, info->depth, info->score, info->nodes, info->qnodes, info->timeInMs,
+					   boardsPerSecond);
+				printListOfMoves(pvMoves);
+				deleteList(pvMoves);
+			}
+			commandResult = RETRY;
+		}
+		else if (0 == strcmp(GET_TOP_MOVES_COMMAND, args[0]))
+		{	// Get the top moves ranked by a single multi-PV search: get_top_moves <d|best> [number of moves]
+			int depth;
+			if ((argc > 1) && (0 == strcmp(args[1], DIFFICULTY_BEST)))
+				depth = DIFFICULTY_BEST_INT;
+			else
+				depth = (argc > 1) ? atoi(args[1]) : 0;
+
+			int numOfMoves = (argc > 2) ? atoi(args[2]) : g_multiPv;
+			if ((depth != DIFFICULTY_BEST_INT) && ((depth < 1) || (depth > MAX_DEPTH)))
+				printf(WRONG_MINIMAX_DEPTH);
+			else if ((numOfMoves < 1) || (numOfMoves > MAX_MULTI_PV))
+				printf(WRONG_MULTI_PV);
+			else
+			{
+				SearchContext context;
+				initCommandSearchContext(&context, depth);
+				LinkedList* topMoves = executeGetTopMovesCommand(&context, board, isUserBlack, numOfMoves);
+				if (g_memError || context.isError)
+					return QUIT;
+
+				SearchInfo* info = &(context.info);
+				unsigned long long boardsPerSecond =
+					(info->nodes * 1000) / (unsigned long long)maxi(1, (int)info->timeInMs);
+				printf(SEARCH_INFO, info->depth, info->score, info->nodes, info->qnodes, info->timeInMs,
+					   boardsPerSecond);
+
+				int rank = 0;
+				Node* currMoveNode = topMoves->head;
+				while (NULL != currMoveNode)
+				{
+					printf(TOP_MOVE, rank + 1, info->lines[rank].value);
+					printMove((Move*)currMoveNode->data);
+					currMoveNode = currMoveNode->next;
+					rank++;
+				}
+
+				deleteList(topMoves);
+			}
+
+			commandResult = RETRY;
+		}
+		else if (0 == strcmp(TT_STATS_COMMAND, args[0]))
+		{	// Transposition table statistics
+			TTStats stats = getTranspositionTableStats();
+			printf(TT_STATS, getTranspositionTableSize(), stats.hits, stats.misses, stats.overwrites);
+
+			commandResult = RETRY;
+		}
 		else if (0 == strcmp(SAVE_COMMAND, args[0]))
 		{	// Save
 			executeSaveCommand(board, args[1], isUserBlack);
@@ -710,7 +1014,11 @@ bool executeUserTurn(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack)
 /* Executes the next turn done by the computer. */
 void executeComputerTurn(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack)
 {
-	Move* nextMove = executeGetNextComputerMoveCommand(board, isUserBlack);
+	SearchContext context;
+	initCommandSearchContext(&context, g_isDifficultyBest ? DIFFICULTY_BEST_INT : g_minimaxDepth);
+	Move* nextMove = executeGetNextComputerMoveCommand(&context, board, isUserBlack);
+	if (context.isError)
+		g_memError = true;	// The game loop quits
 	if (NULL == nextMove)
 		return;
 
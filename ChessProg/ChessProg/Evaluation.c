@@ -0,0 +1,162 @@
+#include <string.h>
+#include "Evaluation.h"
+
+/* The evaluators, in the order of EvaluatorType. */
+const Evaluator g_evaluators[NUM_OF_EVALUATORS] =
+{
+	{ MATERIAL_EVALUATOR_NAME, evaluateMaterial },
+	{ PST_EVALUATOR_NAME, evaluatePieceSquareTables },
+	{ FULL_EVALUATOR_NAME, evaluateFull }
+};
+
+EvaluatorType g_evaluatorType = DEFAULT_EVALUATOR;	// Configured evaluator of the user's searches
+
+/* Returns the score of the board state for the given player from its material only (O(1)). */
+int evaluateMaterial(BoardState* state, bool isABlack)
+{
+	return state->material[isABlack] - state->material[!isABlack];
+}
+
+/*
+ * Returns the score of the board state for the given player from the evaluation terms kept by the state (O(1)):
+ * the material, and the piece-square table scores tapered between the midgame and the endgame by the game phase.
+ */
+int evaluatePieceSquareTables(BoardState* state, bool isABlack)
+{
+	int phase = mini(state->phase[0] + state->phase[1], MAX_GAME_PHASE);	// Promotions may add pieces beyond the starting board
+	int midgame = state->midgame[isABlack] - state->midgame[!isABlack];
+	int endgame = state->endgame[isABlack] - state->endgame[!isABlack];
+
+	return (state->material[isABlack] - state->material[!isABlack])
+		   + (((midgame * phase) + (endgame * (MAX_GAME_PHASE - phase))) / MAX_GAME_PHASE);
+}
+
+/* Returns the mobility score of the pieces of the player: the squares they attack which are not occupied by its own. */
+int getMobilityScore(const BitBoards* bitBoards, bool isBlack)
+{
+	const BitBoard* pieces = bitBoards->pieces[isBlack];
+	BitBoard targets = ~(bitBoards->occupied[isBlack]);
+	BitBoard set;
+	int square;
+	int score = 0;
+
+	for (set = pieces[KNIGHT_TYPE]; set != EMPTY_BITBOARD;)
+	{
+		square = popFirstSquare(&set);
+		score += KNIGHT_MOBILITY_SCORE * countBits(getKnightAttacks(square) & targets);
+	}
+	for (set = pieces[BISHOP_TYPE]; set != EMPTY_BITBOARD;)
+	{
+		square = popFirstSquare(&set);
+		score += BISHOP_MOBILITY_SCORE * countBits(getBishopAttacks(square, bitBoards->all) & targets);
+	}
+	for (set = pieces[ROOK_TYPE]; set != EMPTY_BITBOARD;)
+	{
+		square = popFirstSquare(&set);
+		score += ROOK_MOBILITY_SCORE * countBits(getRookAttacks(square, bitBoards->all) & targets);
+	}
+	for (set = pieces[QUEEN_TYPE]; set != EMPTY_BITBOARD;)
+	{
+		square = popFirstSquare(&set);
+		BitBoard attacks = getBishopAttacks(square, bitBoards->all) | getRookAttacks(square, bitBoards->all);
+		score += QUEEN_MOBILITY_SCORE * countBits(attacks & targets);
+	}
+
+	return score;
+}
+
+/* Returns the squares of the given column and of its neighbouring columns. */
+BitBoard getColumnSpan(int column)
+{
+	BitBoard span = COLUMN_A_BITBOARD << column;
+	if (column > 0)
+		span |= COLUMN_A_BITBOARD << (column - 1);
+	if (column < BOARD_SIZE - 1)
+		span |= COLUMN_A_BITBOARD << (column + 1);
+
+	return span;
+}
+
+/* Returns the pawn structure score of the player: its doubled, isolated and passed pawns. */
+int getPawnStructureScore(const BitBoards* bitBoards, bool isBlack)
+{
+	BitBoard pawns = bitBoards->pieces[isBlack][PAWN_TYPE];
+	BitBoard enemyPawns = bitBoards->pieces[!isBlack][PAWN_TYPE];
+	int score = 0;
+	int column, count;
+	for (column = 0; column < BOARD_SIZE; column++)
+	{
+		count = countBits(pawns & (COLUMN_A_BITBOARD << column));
+		if (count > 1)
+			score -= DOUBLED_PAWN_PENALTY * (count - 1);
+		if ((count > 0) && (EMPTY_BITBOARD == (pawns & getColumnSpan(column) & ~(COLUMN_A_BITBOARD << column))))
+			score -= ISOLATED_PAWN_PENALTY * count;
+	}
+
+	BitBoard set = pawns;
+	BitBoard front;
+	int square, row;
+	while (set != EMPTY_BITBOARD)
+	{
+		square = popFirstSquare(&set);
+		row = SQUARE_ROW(square);
+
+		// The rows in front of the pawn, in its own column and in the neighbouring columns
+		if (isBlack)
+			front = (((BitBoard)1) << (BOARD_SIZE * row)) - 1;
+		else
+			front = (row < BOARD_SIZE - 1) ? (~EMPTY_BITBOARD << (BOARD_SIZE * (row + 1))) : EMPTY_BITBOARD;
+
+		if (EMPTY_BITBOARD == (enemyPawns & front & getColumnSpan(SQUARE_COLUMN(square))))
+			score += PASSED_PAWN_SCORE * maxi(isBlack ? (BOARD_SIZE - 2 - row) : (row - 1), 0);
+	}
+
+	return score;
+}
+
+/*
+ * Returns the score of the board state for the given player by evaluatePieceSquareTables, together with the
+ * mobility of the pieces, the bishop pair and the pawn structure (doubled, isolated and passed pawns).
+ * These terms are computed from a scan of the board, so this evaluator is the slowest.
+ */
+int evaluateFull(BoardState* state, bool isABlack)
+{
+	BitBoards bitBoards;
+	boardToBitBoards(state->board, &bitBoards);
+
+	int scores[NUM_OF_PLAYERS];
+	int player;
+	for (player = 0; player < NUM_OF_PLAYERS; player++)
+	{
+		scores[player] = getMobilityScore(&bitBoards, player) + getPawnStructureScore(&bitBoards, player);
+		if (countBits(bitBoards.pieces[player][BISHOP_TYPE]) >= 2)
+			scores[player] += BISHOP_PAIR_SCORE;
+	}
+
+	return evaluatePieceSquareTables(state, isABlack) + scores[isABlack] - scores[!isABlack];
+}
+
+/* Returns the type of the evaluator of the given name, or NUM_OF_EVALUATORS if there is no such evaluator. */
+EvaluatorType getEvaluatorTypeByName(const char* name)
+{
+	int type;
+	for (type = 0; type < NUM_OF_EVALUATORS; type++)
+	{
+		if (0 == strcmp(g_evaluators[type].name, name))
+			break;
+	}
+
+	return (EvaluatorType)type;
+}
+
+/* Set the evaluator of the user's searches. */
+void setEvaluatorType(EvaluatorType type)
+{
+	g_evaluatorType = type;
+}
+
+/* Returns the evaluator of the user's searches. Default to DEFAULT_EVALUATOR. */
+EvaluatorType getEvaluatorType()
+{
+	return g_evaluatorType;
+}
@@ -0,0 +1,72 @@
+#ifndef EVALUATION_
+#define EVALUATION_
+
+#include "Types.h"
+#include "BitBoard.h"
+#include "BoardManager.h"
+
+#define MATERIAL_EVALUATOR_NAME "material"	// Material only
+#define PST_EVALUATOR_NAME "pst"			// Material and tapered piece-square tables
+#define FULL_EVALUATOR_NAME "full"			// The piece-square tables evaluator, with mobility and pawn structure
+#define WRONG_EVALUATOR "Wrong evaluator. The value should be material, pst or full\n"
+
+/* Terms of the full evaluator, in hundredths of a pawn (as the scores of the search). */
+#define KNIGHT_MOBILITY_SCORE 4		// For every square a knight attacks, which is not occupied by its own pieces
+#define BISHOP_MOBILITY_SCORE 5
+#define ROOK_MOBILITY_SCORE 2
+#define QUEEN_MOBILITY_SCORE 1
+#define BISHOP_PAIR_SCORE 30		// For having both bishops
+#define DOUBLED_PAWN_PENALTY 15		// For every pawn behind another pawn of its player in the same column
+#define ISOLATED_PAWN_PENALTY 10	// For every pawn with no pawns of its player in the neighbouring columns
+#define PASSED_PAWN_SCORE 10		// For every row a pawn with no enemy pawns in front of it has advanced
+
+/* The evaluators the search can score its leaves with. */
+typedef enum
+{
+	MATERIAL_EVALUATOR,
+	PST_EVALUATOR,
+	FULL_EVALUATOR,
+	NUM_OF_EVALUATORS
+} EvaluatorType;
+
+#define DEFAULT_EVALUATOR PST_EVALUATOR
+
+/* An evaluation function: returns the score of the board state for the given player, in hundredths of a pawn. */
+typedef int (*EvaluateFunction)(BoardState* state, bool isABlack);
+
+/* An evaluator the search can be configured with. */
+typedef struct
+{
+	const char* name;			// The name of the evaluator in the console commands and the saved games
+	EvaluateFunction evaluate;
+} Evaluator;
+
+/* The evaluators, in the order of EvaluatorType. */
+extern const Evaluator g_evaluators[NUM_OF_EVALUATORS];
+
+/* Returns the score of the board state for the given player from its material only (O(1)). */
+int evaluateMaterial(BoardState* state, bool isABlack);
+
+/*
+ * Returns the score of the board state for the given player from the evaluation terms kept by the state (O(1)):
+ * the material, and the piece-square table scores tapered between the midgame and the endgame by the game phase.
+ */
+int evaluatePieceSquareTables(BoardState* state, bool isABlack);
+
+/*
+ * Returns the score of the board state for the given player by evaluatePieceSquareTables, together with the
+ * mobility of the pieces, the bishop pair and the pawn structure (doubled, isolated and passed pawns).
+ * These terms are computed from a scan of the board, so this evaluator is the slowest.
+ */
+int evaluateFull(BoardState* state, bool isABlack);
+
+/* Returns the type of the evaluator of the given name, or NUM_OF_EVALUATORS if there is no such evaluator. */
+EvaluatorType getEvaluatorTypeByName(const char* name);
+
+/* Set the evaluator of the user's searches. */
+void setEvaluatorType(EvaluatorType type);
+
+/* Returns the evaluator of the user's searches. Default to DEFAULT_EVALUATOR. */
+EvaluatorType getEvaluatorType();
+
+#endif
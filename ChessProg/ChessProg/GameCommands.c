@@ -6,54 +6,27 @@
 #include "GameCommands.h"
 #include "GameLogic.h"
 #include "Minimax.h"
-
-/* Returns if the 2 positions are equal in their content. */
-bool isEqualPositions(Position* a, Position* b)
-{
-	return ((a->x == b->x) && (a->y == b->y));
-}
-
-/* Returns if the 2 moves are equal in their content. */
-bool isEqualMoves(Move* a, Move* b)
-{
-	// Check initPos
-	if (!isEqualPositions(&a->initPos, &b->initPos))
-		return false;
-
-	// Check nextPos
-	if (!isEqualPositions(&a->nextPos, &b->nextPos))
-		return false;
-
-	// Check promotion
-	if (a->promotion != b->promotion)
-		return false;
-
-	return true;
-}
+#include "TranspositionTable.h"
 
 /** Returns true if the move is a legal move by the given player (black or white).
- *  Validation is done by comparing the move to all legal moves, so make sure to query the mem flag on return.
+ *  Validation is done by comparing the move to all legal moves.
  */
 bool validateMove(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, Move* move)
 {
 	// Validation #3 - Is the move legal (we compare the move against all legal moves)
-	LinkedList* possibleMoves = getMoves(board, isUserBlack);
-	if (g_memError)
-	{
-		return false;
-	}
+	BoardState state;
+	initBoardState(&state, board, isUserBlack);
+	MoveBuffer possibleMoves;
+	generateMoves(&state, &possibleMoves);
 
-	Node* currMoveNode = possibleMoves->head;
+	CompactMove compactMove = encodeMove(move);
 	bool isLegalMove = false;
-	while ((!isLegalMove) && (NULL != currMoveNode))
+	int i;
+	for (i = 0; (!isLegalMove) && (i < possibleMoves.length); i++)
 	{
-		Move* currMove = (Move*)currMoveNode->data;
-		isLegalMove = isEqualMoves(move, currMove);
-		currMoveNode = currMoveNode->next;
+		isLegalMove = (compactMove == possibleMoves.moves[i]);
 	}
 
-	deleteList(possibleMoves);	// Free resources
-
 	return isLegalMove;
 }
 
@@ -95,134 +68,195 @@ LinkedList* executeGetMovesForPosCommand(char board[BOARD_SIZE][BOARD_SIZE], boo
 	}
 
 	// Get the moves and print them
-	LinkedList* possibleMoves = getMovesForSquare(board, pos.x, pos.y);
+	BoardState state;
+	initBoardState(&state, board, isUserBlack);
+	LinkedList* possibleMoves = getMovesForSquare(&state, pos.x, pos.y);
 	
 	return possibleMoves;
 }
 
+/* Prepare the search context of a request of the given depth, or DIFFICULTY_BEST_INT for difficulty best. */
+void initCommandSearchContext(SearchContext* context, int depth)
+{
+	if (depth == DIFFICULTY_BEST_INT)
+		initSearchRequest(context, MAX_DEPTH, true);
+	else	// Depths out of the supported range are clamped into it
+		initSearchRequest(context, depth, false);
+}
+
 /*
- * Return the score for the given move in a minimax tree of the given depth.
- * If there was an allocation error return INT_MIN.
+ * Return the score (in pawns) for the given move in a minimax tree of the depth of the search context.
+ * If the search limits don't allow the depth, the score of the deepest depth completed within them is returned.
+ * If there was an error return INT_MIN (isError of the context is set to true).
  */
-int executeGetScoreCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, int depth, Move* move)
+int executeGetScoreCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, Move* move)
 {
-	GameStep* gameStep = createGameStep(board, move);	// Convert Move to gameStep
-
-	if (g_memError)
+	int score = getMoveScore(context, board, isUserBlack, encodeMove(move));
+	if (context->isError)
 		return INT_MIN;
 
-	doStep(board, gameStep);
-	g_boardsCounter++;
+	return getPawnScore(score);
+}
+
+/*
+ * Return all the moves with the highest score for the current board, in a minimax tree of the depth of the
+ * search context (or the deepest depth reachable within its limits). All the moves are scored by a single search.
+ * List of moves must be freed when usage is complete.
+ * On a search error NULL is returned and isError of the context is set to true.
+ */
+LinkedList* executeGetBestMovesCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack)
+{
+	// A multi-PV search of a single best move, the scores of the moves tied with it are exact as well
+	MoveBuffer possibleMoves;
+	int scores[MAX_MOVES];
+	searchMultiPv(context, board, isUserBlack, 1, &possibleMoves, scores);
+	if (context->isError)
+		return NULL;
 
-	// Call alphabeta algorithm with the requested depth, on the requested move
-	int tempDepth = g_minimaxDepth;
-	if (depth == DIFFICULTY_BEST_INT)
-		g_minimaxDepth = MAX_DEPTH;	// Difficulty best is implemented as the max depth
-	else
-		g_minimaxDepth = depth;
+	// Find the max
+	int i;
+	int maxScore = INT_MIN;
+	for (i = 0; i < possibleMoves.length; i++)
+	{
+		if (scores[i] > maxScore)
+		{
+			maxScore = scores[i];
+		}
+	}
 
-	int score = alphabeta(board, 1, INT_MIN, INT_MAX, !isUserBlack);
+	// Collect the moves with the highest score
+	LinkedList* bestMoves = createList(deleteMove);
+	if (g_memError)
+		return NULL;
 
-	g_minimaxDepth = tempDepth;
+	for (i = 0; i < possibleMoves.length; i++)
+	{
+		if (scores[i] == maxScore)
+		{
+			Move bestMove = decodeMove(possibleMoves.moves[i], isUserBlack);
+			Move* currMove = cloneMove(&bestMove);
+			if (g_memError)
+			{
+				deleteList(bestMoves);
+				return NULL;
+			}
 
-	undoStep(board, gameStep);
-	deleteGameStep(gameStep);
+			insertLast(bestMoves, currMove);
+			if (g_memError)
+			{
+				deleteMove((void*)currMove);
+				deleteList(bestMoves);
+				return NULL;
+			}
+		}
+	}
 
-	return score;
+	return bestMoves;
 }
 
 /*
- * Return all the moves with the highest score for the current board.
- * 'depth' is an argument for the minimax algorithm.
+ * Return the numOfMoves best moves of the current board (1 to MAX_MULTI_PV, fewer if the player has fewer moves),
+ * best first, ranked by a single multi-PV search of the depth of the search context (or the deepest depth reachable
+ * within its limits). The score and principal variation of every move are left in the lines of the info of the
+ * context, in the same order.
  * List of moves must be freed when usage is complete.
+ * On an error NULL is returned (a search error sets isError of the context to true).
  */
-LinkedList* executeGetBestMovesCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, int depth)
+LinkedList* executeGetTopMovesCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack,
+									  int numOfMoves)
 {
-	g_boardsCounter = 0;
-	// Get moves for the current board
-	LinkedList* possibleMoves = getMoves(board, isUserBlack);
-	if (g_memError)
+	MoveBuffer possibleMoves;
+	int scores[MAX_MOVES];
+	searchMultiPv(context, board, isUserBlack, numOfMoves, &possibleMoves, scores);
+	if (context->isError)
 		return NULL;
 
-	// Compute scores using executeGetScoreCommand and find the max
-	int* scores = (int*)malloc(sizeof(int) * possibleMoves->length);
-	if (scores == NULL)
-	{
-		printf("Error: standard function malloc has failed");
-		g_memError = true;
-		deleteList(possibleMoves);
+	LinkedList* topMoves = createList(deleteMove);
+	if (g_memError)
 		return NULL;
-	}
 
-	Node* currMoveNode = possibleMoves->head;
-	int i = 0;
-	int maxScore = INT_MIN;
-	while (NULL != currMoveNode)
+	int i;
+	for (i = 0; i < context->info.numOfLines; i++)
 	{
-		Move* currMove = (Move*)currMoveNode->data;
-		*(scores + i) = executeGetScoreCommand(board, isUserBlack, depth, currMove);
+		Move topMove = decodeMove(context->info.lines[i].moves[0], isUserBlack);
+		Move* currMove = cloneMove(&topMove);
 		if (g_memError)
 		{
-			deleteList(possibleMoves);
-			free(scores);
+			deleteList(topMoves);
 			return NULL;
 		}
 
-		if (*(scores + i) > maxScore)
+		insertLast(topMoves, currMove);
+		if (g_memError)
 		{
-			maxScore = *(scores + i);
+			deleteMove((void*)currMove);
+			deleteList(topMoves);
+			return NULL;
 		}
-
-		currMoveNode = currMoveNode->next;
-		i++;
 	}
 
-	// Collect the moves with the highest score
-	LinkedList* bestMoves = createList(deleteMove);
+	return topMoves;
+}
+
+/*
+ * Return the principal variation of the current board (the moves both players are expected to play, starting with
+ * the best move of the player), searched as a computer move with the given search context. The score, depth and
+ * measures of the search are left in the info of the context.
+ * List of moves must be freed when usage is complete.
+ * On an error NULL is returned (a search error sets isError of the context to true).
+ */
+LinkedList* executeGetPrincipalVariationCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE],
+												bool isUserBlack)
+{
+	minimax(context, board, isUserBlack);
+	if (context->isError)
+		return NULL;
+
+	LinkedList* pvMoves = createList(deleteMove);
 	if (g_memError)
-	{
-		deleteList(possibleMoves);
-		free(scores);
 		return NULL;
-	}
 
-	currMoveNode = possibleMoves->head;
-	i = 0;
-	while (NULL != currMoveNode)
+	// The players take turns along the line
+	bool isBlackMove = isUserBlack;
+	int i;
+	for (i = 0; i < context->info.length; i++)
 	{
-		if (*(scores + i) == maxScore)
+		Move pvMove = decodeMove(context->info.moves[i], isBlackMove);
+		Move* currMove = cloneMove(&pvMove);
+		if (g_memError)
 		{
-			Move* currMove = cloneMove((Move*)currMoveNode->data);
-			insertLast(bestMoves, currMove);
-			if (g_memError)
-			{
-				deleteList(possibleMoves);
-				free(scores);
-				deleteList(bestMoves);
-				return NULL;
-			}
+			deleteList(pvMoves);
+			return NULL;
 		}
 
-		currMoveNode = currMoveNode->next;
-		i++;
-	}
+		insertLast(pvMoves, currMove);
+		if (g_memError)
+		{
+			deleteMove((void*)currMove);
+			deleteList(pvMoves);
+			return NULL;
+		}
 
-	deleteList(possibleMoves);
-	free(scores);
+		isBlackMove = !isBlackMove;
+	}
 
-	return bestMoves;
+	return pvMoves;
 }
 
-/* Fetch the next turn done by the computer. */
-Move* executeGetNextComputerMoveCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack)
+/*
+ * Fetch the next turn done by the computer, searched with the given search context.
+ * Returns NULL if there was an error (a search error sets isError of the context to true).
+ */
+Move* executeGetNextComputerMoveCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack)
 {
 	// Compute next move by computer using the minimax algorithm
 	bool isComputerBlack = !isUserBlack;
-	Move* nextMove = minimax(board, isComputerBlack);
-	if (g_memError)
+	CompactMove nextMove = minimax(context, board, isComputerBlack);
+	if (nextMove == NO_MOVE)
 		return NULL;
 
-	return nextMove;
+	Move move = decodeMove(nextMove, isComputerBlack);
+	return cloneMove(&move);
 }
 
 /*
@@ -231,15 +265,16 @@ Move* executeGetNextComputerMoveCommand(char board[BOARD_SIZE][BOARD_SIZE], bool
  */
 ChessGameState executeCheckMateTieCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isBlack)
 {
-	LinkedList* moves = getMoves(board, isBlack);
-	if (g_memError)
-		return GAME_ERROR;
+	BoardState boardState;
+	initBoardState(&boardState, board, isBlack);
+	MoveBuffer moves;
+	generateMoves(&boardState, &moves);
 
 	ChessGameState state = GAME_ONGOING;
 
 	if (isCheck(board, isBlack))
 	{
-		if (moves->length == 0)
+		if (moves.length == 0)
 		{	// Mate
 			state = isBlack ? GAME_MATE_WHITE_WINS : GAME_MATE_BLACK_WINS;
 		}
@@ -248,18 +283,60 @@ ChessGameState executeCheckMateTieCommand(char board[BOARD_SIZE][BOARD_SIZE], bo
 			state = GAME_CHECK;
 		}
 	}
-	else if (moves->length == 0)
+	else if (moves.length == 0)
 	{	// Tie
 		state = GAME_TIE;
 	}
 
-	deleteList(moves);
 	return state;
 }
 
+/* Returns the castling rights written in a castling tag (see castlingRightsToString). */
+int stringToCastlingRights(const char* str)
+{
+	int rights = NO_CASTLING_RIGHTS;
+	int i;
+	for (i = 0; str[i] != '\0'; i++)
+	{
+		if (str[i] == WHITE_K)
+			rights |= WHITE_KINGSIDE_CASTLING;
+		else if (str[i] == WHITE_Q)
+			rights |= WHITE_QUEENSIDE_CASTLING;
+		else if (str[i] == BLACK_K)
+			rights |= BLACK_KINGSIDE_CASTLING;
+		else if (str[i] == BLACK_Q)
+			rights |= BLACK_QUEENSIDE_CASTLING;
+	}
+
+	return rights;
+}
+
+/*
+ * Write the castling rights to the string as they are saved in the castling tag: the king of a player for its kingside
+ * castling and its queen for its queenside castling (as the pieces are written on the board), or NO_RIGHTS_STR.
+ */
+void castlingRightsToString(int rights, char str[NUM_OF_PLAYERS * 2 + 1])
+{
+	int length = 0;
+	if (rights & WHITE_KINGSIDE_CASTLING)
+		str[length++] = WHITE_K;
+	if (rights & WHITE_QUEENSIDE_CASTLING)
+		str[length++] = WHITE_Q;
+	if (rights & BLACK_KINGSIDE_CASTLING)
+		str[length++] = BLACK_K;
+	if (rights & BLACK_QUEENSIDE_CASTLING)
+		str[length++] = BLACK_Q;
+	str[length] = '\0';
+
+	if (length == 0)
+		strcpy(str, NO_RIGHTS_STR);
+}
+
 /*
  * Load the game settings from the file "path", path being the full or relative path to the file.
  * We assume that the file contains valid data and is correctly formatted.
+ * The castling rights and en passant square tags are optional: games saved before they were added get the castling
+ * rights their board allows, and no en passant square.
  * Return True if the loading ended successfully, else False.
  */
 bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path)
@@ -284,6 +361,9 @@ bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path)
 	// Read the settings
 	done = false;
 	char* token;
+	bool isCastlingRightsLoaded = false;
+	int castlingRights = NO_CASTLING_RIGHTS;
+	int enPassantSquare = NO_EN_PASSANT_SQUARE;
 	while ((!done) && (fscanf(fp, "%s", str) == 1))
 	{
 		token = strtok(str, ">");
@@ -335,7 +415,8 @@ bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path)
 				}
 				else
 				{
-					g_minimaxDepth = atoi(token);
+					// Depths out of the supported range are clamped into it
+					g_minimaxDepth = mini(maxi(atoi(token), 1), MAX_DEPTH);
 					g_isDifficultyBest = false;
 				}
 			}
@@ -368,6 +449,41 @@ bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path)
 				g_isUserBlack = false;
 			}
 		}
+		else if (strcmp(token, EVALUATOR_TAG_BEGIN) == 0)
+		{	// Evaluator tag (optional, games saved before it was added are evaluated with the current evaluator)
+			token = strtok(NULL, ">");
+			token = strtok(token, "<");
+
+			EvaluatorType evaluatorType = getEvaluatorTypeByName(token);
+			if (evaluatorType == NUM_OF_EVALUATORS)
+			{	// Should never reach this code
+				printf(WRONG_FORMAT);
+				fclose(fp);
+				return false;
+			}
+
+			if (evaluatorType != getEvaluatorType())
+			{
+				setEvaluatorType(evaluatorType);
+				clearTranspositionTable();	// The stored scores are of the other evaluator
+			}
+		}
+		else if (strcmp(token, CASTLING_TAG_BEGIN) == 0)
+		{	// Castling rights tag (optional)
+			token = strtok(NULL, ">");
+			token = strtok(token, "<");
+
+			castlingRights = stringToCastlingRights(token);
+			isCastlingRightsLoaded = true;
+		}
+		else if (strcmp(token, EN_PASSANT_TAG_BEGIN) == 0)
+		{	// En passant square tag (optional), a square such as e3
+			token = strtok(NULL, ">");
+			token = strtok(token, "<");
+
+			if (strcmp(token, NO_RIGHTS_STR) != 0)
+				enPassantSquare = SQUARE_INDEX(token[1] - '1', token[0] - 'a');
+		}
 		else if (strcmp(token, BOARD_TAG_BEGIN) == 0)
 		{	// Board tag
 			done = true;
@@ -400,6 +516,12 @@ bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path)
 		row--;
 	}
 
+	// The castlings are only possible while the king and the rook are on their starting squares
+	initGameRights(board);
+	if (isCastlingRightsLoaded)
+		g_castlingRights &= castlingRights;
+	g_enPassantSquare = enPassantSquare;
+
 	fclose(fp);
 	print_board(board);
 	
@@ -407,7 +529,7 @@ bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path)
 }
 
 /*
- * Save the current game state to the file "path".
+ * Save the current game state to the file "path", with the castling rights and en passant square of the game.
  * Return True if the saving ended successfully, else False.
  */
 bool executeSaveCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path, bool isBlackTurn)
@@ -454,6 +576,20 @@ bool executeSaveCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path, bool isB
 	}	
 	fprintf(fp, "%s\n", USER_COLOR_TAG_END);
 
+	// Write the evaluator
+	fprintf(fp, "\t%s>%s%s\n", EVALUATOR_TAG_BEGIN, g_evaluators[getEvaluatorType()].name, EVALUATOR_TAG_END);
+
+	// Write the castling rights and the en passant square
+	char castlingRights[NUM_OF_PLAYERS * 2 + 1];
+	castlingRightsToString(g_castlingRights, castlingRights);
+	fprintf(fp, "\t%s>%s%s\n", CASTLING_TAG_BEGIN, castlingRights, CASTLING_TAG_END);
+	fprintf(fp, "\t%s>", EN_PASSANT_TAG_BEGIN);
+	if (g_enPassantSquare == NO_EN_PASSANT_SQUARE)
+		fprintf(fp, "%s", NO_RIGHTS_STR);
+	else
+		fprintf(fp, "%c%d", 'a' + SQUARE_COLUMN(g_enPassantSquare), SQUARE_ROW(g_enPassantSquare) + 1);
+	fprintf(fp, "%s\n", EN_PASSANT_TAG_END);
+
 	// Write the board
 	fprintf(fp, "\t%s>\n", BOARD_TAG_BEGIN);
 	int row, j;
@@ -3,6 +3,7 @@
 
 #include "Types.h"
 #include "LinkedList.h"
+#include "Minimax.h"
 
 #define DIFFICULTY_BEST_INT -1
 
@@ -18,6 +19,13 @@
 #define DIFFICULTY_TAG_END "</difficulty>"
 #define USER_COLOR_TAG_BEGIN "<user_color"
 #define USER_COLOR_TAG_END "</user_color>"
+#define EVALUATOR_TAG_BEGIN "<evaluator"
+#define EVALUATOR_TAG_END "</evaluator>"
+#define CASTLING_TAG_BEGIN "<castling"
+#define CASTLING_TAG_END "</castling>"
+#define EN_PASSANT_TAG_BEGIN "<en_passant"
+#define EN_PASSANT_TAG_END "</en_passant>"
+#define NO_RIGHTS_STR "-"	// The content of the castling / en passant tags when there are none
 #define BOARD_TAG_BEGIN "<board"
 #define BOARD_TAG_END "</board>"
 #define ROW_TAG_BEGIN "<row_"
@@ -36,7 +44,7 @@ typedef enum
 } ChessGameState;
 
 /** Returns true if the move is a legal move by the given player (black or white).
- *  Validation is done by comparing the move to all legal moves, so make sure to query the mem flag on return.
+ *  Validation is done by comparing the move to all legal moves.
  */
 bool validateMove(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, Move* move);
 
@@ -54,21 +62,50 @@ bool executeMoveCommand(char board[BOARD_SIZE][BOARD_SIZE], Move* move);
  */
 LinkedList* executeGetMovesForPosCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, Position pos);
 
+/* Prepare the search context of a request of the given depth, or DIFFICULTY_BEST_INT for difficulty best. */
+void initCommandSearchContext(SearchContext* context, int depth);
+
+/*
+ * Return the score (in pawns) for the given move in a minimax tree of the depth of the search context.
+ * If the search limits don't allow the depth, the score of the deepest depth completed within them is returned.
+ * If there was an error return INT_MIN (isError of the context is set to true).
+ */
+int executeGetScoreCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, Move* move);
+
 /*
- * Return the score for the given move in a minimax tree of the given depth.
- * If there was an allocation error return INT_MIN.
+ * Return all the moves with the highest score for the current board, in a minimax tree of the depth of the
+ * search context (or the deepest depth reachable within its limits). All the moves are scored by a single search.
+ * List of moves must be freed when usage is complete.
+ * On a search error NULL is returned and isError of the context is set to true.
  */
-int executeGetScoreCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, int depth, Move* move);
+LinkedList* executeGetBestMovesCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack);
 
 /*
- * Return all the moves with the highest score for the current board.
- * 'depth' is an argument for the minimax algorithm.
+ * Return the numOfMoves best moves of the current board (1 to MAX_MULTI_PV, fewer if the player has fewer moves),
+ * best first, ranked by a single multi-PV search of the depth of the search context (or the deepest depth reachable
+ * within its limits). The score and principal variation of every move are left in the lines of the info of the
+ * context, in the same order.
  * List of moves must be freed when usage is complete.
+ * On an error NULL is returned (a search error sets isError of the context to true).
  */
-LinkedList* executeGetBestMovesCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack, int depth);
+LinkedList* executeGetTopMovesCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack,
+									  int numOfMoves);
 
-/* Fetch the next turn done by the computer. */
-Move* executeGetNextComputerMoveCommand(char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack);
+/*
+ * Return the principal variation of the current board (the moves both players are expected to play, starting with
+ * the best move of the player), searched as a computer move with the given search context. The score, depth and
+ * measures of the search are left in the info of the context.
+ * List of moves must be freed when usage is complete.
+ * On an error NULL is returned (a search error sets isError of the context to true).
+ */
+LinkedList* executeGetPrincipalVariationCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE],
+												bool isUserBlack);
+
+/*
+ * Fetch the next turn done by the computer, searched with the given search context.
+ * Returns NULL if there was an error (a search error sets isError of the context to true).
+ */
+Move* executeGetNextComputerMoveCommand(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isUserBlack);
 
 /* Check for checkmate or a tie and return the state of the board.
  * Note: mate or tie are termination cases.
@@ -78,12 +115,14 @@ ChessGameState executeCheckMateTieCommand(char board[BOARD_SIZE][BOARD_SIZE], bo
 /*
  * Load the game settings from the file "path", path being the full or relative path to the file.
  * We assume that the file contains valid data and is correctly formatted.
+ * The castling rights and en passant square tags are optional: games saved before they were added get the castling
+ * rights their board allows, and no en passant square.
  * Return True if the loading ended successfully, else False.
  */
 bool executeLoadCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path);
 
 /* 
- * Save the current game state to the file "path". 
+ * Save the current game state to the file "path", with the castling rights and en passant square of the game.
  * Return True if the saving ended successfully, else False.
  */
 bool executeSaveCommand(char board[BOARD_SIZE][BOARD_SIZE], char* path, bool isBlackTurn);
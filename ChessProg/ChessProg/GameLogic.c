@@ -1,290 +1,83 @@
 #include <stdlib.h>
 #include "BoardManager.h"
+#include "BitBoard.h"
 #include "GameLogic.h"
 #include "Types.h"
 
-/* -- Functions -- */
-
-/*
-* Returns true / false if a pawn is threatening the given king
-* Input:
-*		board ~ The chess game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*/
-bool isPawnThreatningKing(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Position* kingPos)
-{
-	// Test for threatening pawns
-	// Check forward move
-	int threatX = kingPos->x;
-	int threatY = kingPos->y;
-
-	if (isTestForBlackPlayer)
-		threatX -= 1; // Black king is threatened by pawns below
-	else
-		threatX += 1; // Black king is threatened by pawns above
-
-	return isSquareOccupiedByPawn(board, !isTestForBlackPlayer, threatX, threatY + 1) ||
-		   isSquareOccupiedByPawn(board, !isTestForBlackPlayer, threatX, threatY - 1);
-}
-
-/*
-* Returns true / false if a queen, rook or bishop threatens the king from the given direction
-* Input:
-*		board ~ The game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*		deltaX, deltaY ~ The direction the threat advances in.
-*/
-bool isDirectionThreat(char board[BOARD_SIZE][BOARD_SIZE],
-					   bool isTestForBlackPlayer, Position* kingPos, int deltaX, int deltaY)
-{
-	// First square on the diagonal / row / column
-	Position currentSquare = { kingPos->x + deltaX, kingPos->y + deltaY };
+/* The rays of the bishops and rooks (indices of g_directions), in the order their moves are generated. */
+const int g_bishopDirections[NUM_OF_DIRECTIONS / 2] = { 6, 4, 5, 7 };
+const int g_rookDirections[NUM_OF_DIRECTIONS / 2] = { 0, 2, 1, 3 };
 
-	// We advance along the direction, advancing by deltaX, Y each iteration.
-	// We will stop once we no longer hit an empty square.
-	while (isSquareVacant(board, currentSquare.x, currentSquare.y))
-	{
-		currentSquare.x += deltaX;
-		currentSquare.y += deltaY;
-	}
-
-	// If the reason we stopped iterating was we encountered an enemy piece,
-	// we check if that enemy piece is a threat.
-	// Note the queen threatens from all directions, bishop only from diagonal and rook from vertical & horizontal lines
-	bool isBishopThreating = isSquareOccupiedByBishop(board, !isTestForBlackPlayer, currentSquare.x, currentSquare.y);
-	bool isRookThreating = isSquareOccupiedByRook(board, !isTestForBlackPlayer, currentSquare.x, currentSquare.y);
-	bool isQueenThreating = isSquareOccupiedByQueen(board, !isTestForBlackPlayer, currentSquare.x, currentSquare.y);
-	bool isHorVertThreat = ((deltaX == 0) || (deltaY == 0));
-	bool isDiagonalThreat = (abs(deltaX) == abs(deltaY));
-
-	return ((isQueenThreating && (isHorVertThreat || isDiagonalThreat )) ||
-		    (isBishopThreating && isDiagonalThreat) ||
-			(isRookThreating && isHorVertThreat));
-}
-
-/*
-* Returns true / false if a bishop or queen (diagonal) is threatening the given king
-* Input:
-*		board ~ The chess game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*/
-bool isBishopQueenThreatningKing(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Position* kingPos)
-{
-	return isDirectionThreat(board, isTestForBlackPlayer, kingPos, -1,  1)  ||
-		   isDirectionThreat(board, isTestForBlackPlayer, kingPos,  1, -1)  ||
-		   isDirectionThreat(board, isTestForBlackPlayer, kingPos,  1,  1)  ||
-		   isDirectionThreat(board, isTestForBlackPlayer, kingPos, -1, -1);
-}
-
-/*
-* Returns true / false if a rook or queen (diagonal) is threatening the given king
-* Input:
-*		board ~ The chess game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*/
-bool isRookQueenThreatningKing(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Position* kingPos)
-{
-	return isDirectionThreat(board, isTestForBlackPlayer, kingPos,  0,  1) ||
-		   isDirectionThreat(board, isTestForBlackPlayer, kingPos,  1,  0) ||
-		   isDirectionThreat(board, isTestForBlackPlayer, kingPos,  0, -1) ||
-		   isDirectionThreat(board, isTestForBlackPlayer, kingPos, -1,  0);
-}
-
-/*
-* Returns true / false if a knight is threatening the given king
-* Input:
-*		board ~ The chess game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*/
-bool isKnightThreatningKing(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Position* kingPos)
-{
-	// The knight leaps forward in a "L shape" manner, therefore there are 8 possibilities
-	return (isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x - 1, kingPos->y - 2) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x - 2, kingPos->y - 1) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x + 1, kingPos->y - 2) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x + 2, kingPos->y - 1) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x - 1, kingPos->y + 2) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x - 2, kingPos->y + 1) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x + 1, kingPos->y + 2) ||
-			isSquareOccupiedByKnight(board, !isTestForBlackPlayer, kingPos->x + 2, kingPos->y + 1));
-}
-
-/*
-* Returns true / false if a king is threatening the given king
-* Input:
-*		board ~ The chess game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*/
-bool isKingThreatningKing(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Position* kingPos)
-{
-	// The king can move one square in any direction
-	return (isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x + 1, kingPos->y + 1) ||
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x - 1, kingPos->y + 1) || 
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x + 1, kingPos->y - 1) || 
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x - 1, kingPos->y - 1) ||
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x + 1, kingPos->y) ||
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x - 1, kingPos->y) ||
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x, kingPos->y + 1) ||
-			isSquareOccupiedByKing(board, !isTestForBlackPlayer, kingPos->x, kingPos->y - 1));
-}
-
-/*
-* Returns either whether the black player (isTestForBlackPlayer == true) is in check,
-* or the white player (isTestForBlackPlayer == false) is in check.
-* Input:
-*		board ~ The chess game board.
-*		isTestForBlackPlayer ~ True if check if black king is under check. False for white king.
-*		kingPos ~ Where the king piece is currently located.
-*/
-bool isKingUnderCheck(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Position* kingPos)
-{
-	return isPawnThreatningKing(board, isTestForBlackPlayer, kingPos) ||
-		   isBishopQueenThreatningKing(board, isTestForBlackPlayer, kingPos) ||
-		   isRookQueenThreatningKing(board, isTestForBlackPlayer, kingPos) ||
-		   isKnightThreatningKing(board, isTestForBlackPlayer, kingPos) ||
-		   isKingThreatningKing(board, isTestForBlackPlayer, kingPos);
-}
-
-/*
- * Returns if the move is valid (doesn't cause the current player a check).
- * Move is from startPos to target.
- * - Move is expected to already be valid in terms of piece type constraints
- *	(e.g: a peon can only move to 3 possible squares).
- * Input:
- *		board ~ The chess game board.
- *		isMovesForBlackPlayer ~ True if current player is black. False if white.
- *		startPos ~ Where the piece is currently located.
- *		targetX, targetY ~ Coordinates of where the piece will move to.
- *		kingPos ~ Current position of the current player's king (following the execution of the move).
- */
-bool isValidMove(char board[BOARD_SIZE][BOARD_SIZE], bool isMovesForBlackPlayer,
-				 Position* startPos, int targetX, int targetY, Position* kingPos)
-{
-	// First update the board as if the move is executed.
-	// We don't bother taking peon promotion into consideration since this is irrelevant for the check validity test
-	// (promoting a peon of the current player shouldn't cause the king of the current player be in check).
-	char piece = board[startPos->x][startPos->y];
-	char target = board[targetX][targetY];
-	board[startPos->x][startPos->y] = EMPTY;
-	board[targetX][targetY] = piece;
-
-	bool isValid = !isKingUnderCheck(board, isMovesForBlackPlayer, kingPos);
-
-	// Restore the board to its original state
-	board[startPos->x][startPos->y] = piece;
-	board[targetX][targetY] = target;
-
-	return isValid;
-}
+/* -- Functions -- */
 
 /*
- * Add an available move for the player to the list of moves.
+ * Add an available move for the player to the buffer of moves.
  * - Move is expected to be valid in terms of piece type constraints (e.g: a peon can only move to 3 possible squares).
- * - Additional validation will be done in this function (moves that result in a check status for the current player are
- *	 illegal).
- * --> If the move is legal, it is added to the list of possibleMoves. Otherwise nothing happens.
+ * - The move is not tested for leaving the king of the player in check (see isLegalMove).
  * Input:
- *		board ~ The chess game board.
- *		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+ *		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
  *						possible eat / position change moves.
- *		isMovesForBlackPlayer ~ True if current player is black. False if white.
  *		startPos ~ Where the piece is currently located.
  *		targetX, targetY ~ Coordinates of where the piece will move to.
- *		kingPos ~ Current position of the current player's king (following the execution of the move).
  */
-bool addPossibleMove(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves, bool isMovesForBlackPlayer,
-					 Position* startPos, int targetX, int targetY, Position* kingPos)
+bool addPossibleMove(MoveBuffer* possibleMoves, Position* startPos, int targetX, int targetY)
 {
-	// Check if the move doesn't cause the current player a check. If it does, we don't count it.
-	if (!isValidMove(board, isMovesForBlackPlayer, startPos, targetX, targetY, kingPos))
-		return false;
-
-	Position targetPos = { targetX, targetY };
-
-	Move* newMove = createMove(startPos, &targetPos);
-	if (g_memError)
-		return false;
+	if (possibleMoves->length >= MAX_MOVES)
+		return false; // Can't happen in a legal chess game, the buffer is larger than the maximal number of moves
 
-	insertLast(possibleMoves, newMove);
-	if (g_memError)
-	{
-		deleteMove((void*)newMove);
-		return false;
-	}
+	possibleMoves->moves[possibleMoves->length++] = COMPACT_MOVE(SQUARE_INDEX(startPos->x, startPos->y),
+																 SQUARE_INDEX(targetX, targetY), NO_PROMOTION_TYPE);
 
 	return true;
 }
 
 /*
-* Add an available move for the player to the list of moves, the move is specifically created for peons,
+* Add an available move for the player to the buffer of moves, the move is specifically created for peons,
 * as it may contain promotions.
 * - Move is expected to be valid in terms of piece type constraints (e.g: a peon can only move to 3 possible squares).
-* - Additional validation will be done in this function (moves that result in a check status for the current player are
-*	 illegal).
-* --> If the move is legal, it is added to the list of possibleMoves. Otherwise nothing happens.
+* - The move is not tested for leaving the king of the player in check (see isLegalMove).
 * Input:
-*		board ~ The chess game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
 *		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
 *		targetX, targetY ~ Coordinates of where the piece will move to.
-*		kingPos ~ Current position of the current player's king (following the execution of the move).
 */
-void addPeonMove(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves, bool isMovesForBlackPlayer,
-					  Position* startPos, int targetX, int targetY, Position* kingPos)
+void addPeonMove(MoveBuffer* possibleMoves, bool isMovesForBlackPlayer, Position* startPos, int targetX, int targetY)
 {
-	bool isMoveAdded = addPossibleMove(board, possibleMoves, isMovesForBlackPlayer, startPos, targetX, targetY, kingPos);
-	if (g_memError)
-		return;
-	if (!isMoveAdded)
-		return;
-
-	// If the pawn reaches the edge, the moves become promotion moves.
-	if (isSquareOnOppositeEdge(isMovesForBlackPlayer, targetX))
+	if (!isSquareOnOppositeEdge(isMovesForBlackPlayer, targetX))
 	{
-		char bishop = isMovesForBlackPlayer ? BLACK_B : WHITE_B;
-		char rook = isMovesForBlackPlayer ? BLACK_R : BLACK_R;
-		char knight = isMovesForBlackPlayer ? BLACK_N : WHITE_N;
-		char queen = isMovesForBlackPlayer ? BLACK_Q : WHITE_Q;
-
-		((Move*)(possibleMoves->tail->data))->promotion = queen; // Update the most recent move to a promotion move.
+		addPossibleMove(possibleMoves, startPos, targetX, targetY);
+		return;
+	}
 
-		addPossibleMove(board, possibleMoves, isMovesForBlackPlayer, startPos, targetX, targetY, kingPos);
-		if (g_memError)
-			return;
-		((Move*)(possibleMoves->tail->data))->promotion = rook; // Update the most recent move to a promotion move.
+	// If the pawn reaches the edge, the move becomes the promotion moves, which are legal exactly when the plain
+	// move is. Room is reserved for all of them up front, so a plain move to the edge never stays in the buffer.
+	if (possibleMoves->length + NUM_OF_PROMOTIONS > MAX_MOVES)
+		return; // Can't happen in a legal chess game, as in addPossibleMove
 
-		addPossibleMove(board, possibleMoves, isMovesForBlackPlayer, startPos, targetX, targetY, kingPos);
-		if (g_memError)
-			return;
-		((Move*)(possibleMoves->tail->data))->promotion = bishop; // Update the most recent move to a promotion move.
+	addPossibleMove(possibleMoves, startPos, targetX, targetY);
+	CompactMove move = possibleMoves->moves[possibleMoves->length - 1];
 
-		addPossibleMove(board, possibleMoves, isMovesForBlackPlayer, startPos, targetX, targetY, kingPos);
-		if (g_memError)
-			return;
-		((Move*)(possibleMoves->tail->data))->promotion = knight; // Update the most recent move to a promotion move.
-	}
+	// Update the most recent move to a promotion move, then add the rest of the promotions.
+	possibleMoves->moves[possibleMoves->length - 1] = move | COMPACT_MOVE(0, 0, QUEEN_TYPE);
+	possibleMoves->moves[possibleMoves->length++] = move | COMPACT_MOVE(0, 0, ROOK_TYPE);
+	possibleMoves->moves[possibleMoves->length++] = move | COMPACT_MOVE(0, 0, BISHOP_TYPE);
+	possibleMoves->moves[possibleMoves->length++] = move | COMPACT_MOVE(0, 0, KNIGHT_TYPE);
 }
 
 /*
  * Get possible moves for current Pawn piece.
  * Input:
  *		board ~ The game board.
- *		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+ *		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
  *						possible eat / position change moves.
  *		isMovesForBlackPlayer ~ True if current player is black. False if white.
  *		startPos ~ Where the piece is currently located.
- *		kingPos ~ Current position of the current player's king.
+ *		enPassantSquare ~ The square the pawn may eat en passant on, or NO_EN_PASSANT_SQUARE.
  */
-void getPawnMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-				  bool isMovesForBlackPlayer, Position* startPos, Position* kingPos)
+void getPawnMoves(char board[BOARD_SIZE][BOARD_SIZE], MoveBuffer* possibleMoves,
+				  bool isMovesForBlackPlayer, Position* startPos, int enPassantSquare)
 {
 	// Check forward move
 	int advanceX = startPos->x;
@@ -295,151 +88,119 @@ void getPawnMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
 	else
 		advanceX += 1; // White player advances upwards
 
-	// Check if the pawn can move forward to a vacant spot
+	// Check if the pawn can move forward to a vacant spot, and from its starting row to the vacant spot after it
 	if (isSquareVacant(board, advanceX, advanceY))
 	{
-		addPeonMove(board, possibleMoves, isMovesForBlackPlayer, startPos, advanceX, advanceY, kingPos);
-	}
-	if (g_memError)
-		return;
+		addPeonMove(possibleMoves, isMovesForBlackPlayer, startPos, advanceX, advanceY);
 
-	// Check if the pawn can eat in 1st diagonal
-	advanceY = startPos->y + 1;
-	if (isSquareOccupiedByEnemy(board, isMovesForBlackPlayer, advanceX, advanceY))
-		addPeonMove(board, possibleMoves, isMovesForBlackPlayer, startPos, advanceX, advanceY, kingPos);
-	if (g_memError)
-		return;
+		int doubleAdvanceX = advanceX + (advanceX - startPos->x);
+		if ((startPos->x == PAWN_START_ROW(isMovesForBlackPlayer)) && isSquareVacant(board, doubleAdvanceX, advanceY))
+			addPossibleMove(possibleMoves, startPos, doubleAdvanceX, advanceY);
+	}
 
-	// Check if the pawn can eat in 2nd diagonal
-	advanceY = startPos->y - 1;
-	if (isSquareOccupiedByEnemy(board, isMovesForBlackPlayer, advanceX, advanceY))
-		addPeonMove(board, possibleMoves, isMovesForBlackPlayer, startPos, advanceX, advanceY, kingPos);
-	if (g_memError)
-		return;
+	// Check if the pawn can eat in the 1st and 2nd diagonals, an enemy piece or an enemy pawn that passed en passant.
+	// The en passant square is only used in its row for the player, as it may be left from the player's own push.
+	bool isEnPassantForPlayer = (enPassantSquare != NO_EN_PASSANT_SQUARE) &&
+								(SQUARE_ROW(enPassantSquare) == EN_PASSANT_ROW(isMovesForBlackPlayer));
+	const TargetList* targets = &(g_pawnTargets[isMovesForBlackPlayer][SQUARE_INDEX(startPos->x, startPos->y)]);
+	int i;
+	for (i = 0; i < targets->length; i++)
+	{
+		advanceX = SQUARE_ROW(targets->squares[i]);
+		advanceY = SQUARE_COLUMN(targets->squares[i]);
+		char soldier = board[advanceX][advanceY];
+		if ((soldier != EMPTY) && (isBlackSoldier(soldier) != isMovesForBlackPlayer))
+			addPeonMove(possibleMoves, isMovesForBlackPlayer, startPos, advanceX, advanceY);
+		else if (isEnPassantForPlayer && (targets->squares[i] == enPassantSquare))
+			addPossibleMove(possibleMoves, startPos, advanceX, advanceY);
+	}
 }
 
 /*
-* Checks if a piece can move / eat in the given direction.
+* Add the moves of a sliding piece to its target squares, ray after ray in the given directions, each ray from the
+* square next to the piece outwards. The targets of a ray are the squares up to its first piece, so they are contiguous.
 * Input:
-*		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
-*		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
-*		deltaX, deltaY ~ The direction the piece advances in.
-*		kingPos ~ Current position of the current player's king.
+*		targets ~ The squares the piece attacks, without the squares of the pieces of the player.
+*		directions ~ The rays of the piece (indices of g_directions), in the order their moves are added.
 */
-void queryDirection(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-					bool isMovesForBlackPlayer, Position* startPos, int deltaX, int deltaY, Position* kingPos)
+void addSlidingMoves(MoveBuffer* possibleMoves, Position* startPos, BitBoard targets,
+					 const int directions[NUM_OF_DIRECTIONS / 2])
 {
-	// First square on the diagonal / row / column
-	Position currentSquare = { startPos->x + deltaX, startPos->y + deltaY };
-
-	// We advance along the direction, advancing by deltaX, Y each iteration.
-	// We will stop once we no longer hit an empty square.
-	while (isSquareVacant(board, currentSquare.x, currentSquare.y))
-	{
-		addPossibleMove(board, possibleMoves, isMovesForBlackPlayer,startPos, currentSquare.x, currentSquare.y, kingPos);
-		if (g_memError)
-			return;
-
-		currentSquare.x += deltaX;
-		currentSquare.y += deltaY;
-	}
-
-	// If the reason we stopped iterating was we encountered an enemy piece, we get an additional move: an eat move.
-	if (isSquareOccupiedByEnemy(board, isMovesForBlackPlayer, currentSquare.x, currentSquare.y))
+	int square = SQUARE_INDEX(startPos->x, startPos->y);
+	int i;
+	for (i = 0; i < NUM_OF_DIRECTIONS / 2; i++)
 	{
-		addPossibleMove(board, possibleMoves, isMovesForBlackPlayer, startPos, currentSquare.x, currentSquare.y, kingPos);
+		int direction = directions[i];
+		int step = SQUARE_INDEX(g_directions[direction][0], g_directions[direction][1]);
+		BitBoard rayTargets = targets & g_rayMasks[direction][square];
+		int target = square;
+		while (rayTargets != EMPTY_BITBOARD)
+		{
+			target += step;
+			rayTargets &= ~SQUARE_BIT(target);
+			addPossibleMove(possibleMoves, startPos, SQUARE_ROW(target), SQUARE_COLUMN(target));
+		}
 	}
 }
 
 /*
 * Get possible moves for current Bishop piece.
 * Input:
-*		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
-*		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
-*		kingPos ~ Current position of the current player's king.
+*		occupied ~ The occupied squares of the board.
+*		own ~ The squares of the pieces of the current player.
 */
-void getBishopMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-					bool isMovesForBlackPlayer, Position* startPos, Position* kingPos)
+void getBishopMoves(MoveBuffer* possibleMoves, Position* startPos, BitBoard occupied, BitBoard own)
 {
-	// Check move / eat in 4 diagonal directions:
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, 1, kingPos);
-	if (g_memError)
-		return;
-
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, 1, kingPos);
-	if (g_memError)
-		return;
-
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, -1, kingPos);
-	if (g_memError)
-		return;
-
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, -1, kingPos);
+	// Move / eat in 4 diagonal directions, up to the first piece on each
+	BitBoard targets = getBishopAttacks(SQUARE_INDEX(startPos->x, startPos->y), occupied) & ~own;
+	addSlidingMoves(possibleMoves, startPos, targets, g_bishopDirections);
 }
 
 /*
 * Get possible moves for current Rook piece.
 * Input:
-*		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
-*		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
-*		kingPos ~ Current position of the current player's king.
+*		occupied ~ The occupied squares of the board.
+*		own ~ The squares of the pieces of the current player.
 */
-void getRookMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-				  bool isMovesForBlackPlayer, Position* startPos, Position* kingPos)
+void getRookMoves(MoveBuffer* possibleMoves, Position* startPos, BitBoard occupied, BitBoard own)
 {
-	// Check move / eat in 4 cross directions:
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, 0, 1, kingPos);
-	if (g_memError)
-		return;
-
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, 0, -1, kingPos);
-	if (g_memError)
-		return;
-
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, 0, kingPos);
-	if (g_memError)
-		return;
-
-	queryDirection(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, 0, kingPos);
+	// Move / eat in 4 cross directions, up to the first piece on each
+	BitBoard targets = getRookAttacks(SQUARE_INDEX(startPos->x, startPos->y), occupied) & ~own;
+	addSlidingMoves(possibleMoves, startPos, targets, g_rookDirections);
 }
 
 /*
-* Add possible move for a single spot, if that spot is available for moving to or eating an enemy piece.
+* Add possible moves to the squares of the target list (of the attack tables), for every square that is available for
+* moving to or eating an enemy piece. The squares of the list are on the board, so no bounds checks are needed.
 * Input:
 *		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
 *		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
-*		deltaX, deltaY ~ How many squares away to move the piece to.
-*		kingPos ~ Current position of the current player's king.
+*		targets ~ The squares the piece attacks.
 */
-void querySinglePos(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-					bool isMovesForBlackPlayer, Position* startPos, int deltaX, int deltaY, Position* kingPos)
+void queryTargetSquares(char board[BOARD_SIZE][BOARD_SIZE], MoveBuffer* possibleMoves,
+						bool isMovesForBlackPlayer, Position* startPos, const TargetList* targets)
 {
-	Position nextSquare = { startPos->x + deltaX, startPos->y + deltaY  };
-
-	if (isSquareVacant(board, nextSquare.x, nextSquare.y) ||
-		isSquareOccupiedByEnemy(board, isMovesForBlackPlayer, nextSquare.x, nextSquare.y))
+	int i;
+	for (i = 0; i < targets->length; i++)
 	{
-		Position* kingPosArg;
-
-		// When the king moves, we should update the kingPos parameter accordingly
-		if ((startPos->x == kingPos->x) && (startPos->y == kingPos->y))
-			kingPosArg = &nextSquare; // The king's updated position is where the king moves to
-		else
-			kingPosArg = kingPos; // The current move is not made by a king, the kingPos stays the same
+		int x = SQUARE_ROW(targets->squares[i]);
+		int y = SQUARE_COLUMN(targets->squares[i]);
+		char soldier = board[x][y];
 
-		addPossibleMove(board, possibleMoves, isMovesForBlackPlayer, startPos, nextSquare.x, nextSquare.y, kingPosArg);
+		if ((soldier == EMPTY) || (isBlackSoldier(soldier) != isMovesForBlackPlayer))
+			addPossibleMove(possibleMoves, startPos, x, y);
 	}
 }
 
@@ -447,150 +208,142 @@ void querySinglePos(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMove
 * Get possible moves for current Knight piece.
 * Input:
 *		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
 *		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
-*		kingPos ~ Current position of the current player's king.
 */
-void getKnightMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-					bool isMovesForBlackPlayer, Position* startPos, Position* kingPos)
+void getKnightMoves(char board[BOARD_SIZE][BOARD_SIZE], MoveBuffer* possibleMoves,
+					bool isMovesForBlackPlayer, Position* startPos)
 {
-	// The knight leaps forward in a "L shape" manner, therefore there are 8 possibilities
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, 2, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 2, 1, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, 2, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -2, 1, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, -2, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 2, -1, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, -2, kingPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -2, -1, kingPos);
+	// The knight leaps forward in a "L shape" manner, to the (up to 8) squares of its target list
+	queryTargetSquares(board, possibleMoves, isMovesForBlackPlayer, startPos,
+					   &(g_knightTargets[SQUARE_INDEX(startPos->x, startPos->y)]));
 }
 
 /*
 * Get possible moves for current Queen piece.
 * Input:
-*		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
-*		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the piece is currently located.
-*		kingPos ~ Current position of the current player's king.
+*		occupied ~ The occupied squares of the board.
+*		own ~ The squares of the pieces of the current player.
 */
-void getQueenMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-				   bool isMovesForBlackPlayer, Position* startPos, Position* kingPos)
+void getQueenMoves(MoveBuffer* possibleMoves, Position* startPos, BitBoard occupied, BitBoard own)
 {
 	// The queen combines the power of a bishop and a rook
-	getBishopMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
-	if (g_memError)
-		return;
-	getRookMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
+	getBishopMoves(possibleMoves, startPos, occupied, own);
+	getRookMoves(possibleMoves, startPos, occupied, own);
+}
+
+/*
+* Returns if the king of the player may castle to the side of the rook in the given column: it has the castling right,
+* its rook is in the corner and the squares between them are vacant. The squares the king passes are tested for
+* attacks by isLegalMove.
+*/
+bool isCastlingPossible(char board[BOARD_SIZE][BOARD_SIZE], bool isMovesForBlackPlayer, int castlingRights,
+						int castling, int rookColumn)
+{
+	int row = HOME_ROW(isMovesForBlackPlayer);
+	if ((castlingRights & castling) == 0)
+		return false;
+	if (board[row][rookColumn] != getSoldierChar(ROOK_TYPE, isMovesForBlackPlayer))
+		return false;
+
+	int step = (rookColumn > KING_START_COLUMN) ? 1 : -1;
+	int y;
+	for (y = KING_START_COLUMN + step; y != rookColumn; y += step)
+	{
+		if (board[row][y] != EMPTY)
+			return false;
+	}
+
+	return true;
 }
 
 /*
 * Get possible moves for current King piece.
 * Input:
 *		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, we aggregate it as we check
+*		possibleMoves ~ A buffer of possible moves by the current player, we aggregate it as we check
 *						possible eat / position change moves.
 *		isMovesForBlackPlayer ~ True if current player is black. False if white.
-*		startPos ~ Where the piece is currently located. Also the current position of the current player's king.
+*		startPos ~ Where the piece is currently located.
+*		castlingRights ~ The castling rights of the players.
 */
-void getKingMoves(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-				  bool isMovesForBlackPlayer, Position* startPos)
+void getKingMoves(char board[BOARD_SIZE][BOARD_SIZE], MoveBuffer* possibleMoves,
+				  bool isMovesForBlackPlayer, Position* startPos, int castlingRights)
 {
 	// The king can move one square in any direction.
-	// Remember that for the king - startPos == kingPos..
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 0, 1, startPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 0, -1, startPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, 0, startPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, 0, startPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, 1, startPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, 1, startPos);
-	if (g_memError)
-		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, 1, -1, startPos);
-	if (g_memError)
+	queryTargetSquares(board, possibleMoves, isMovesForBlackPlayer, startPos,
+					   &(g_kingTargets[SQUARE_INDEX(startPos->x, startPos->y)]));
+
+	// Or two squares towards a rook it may castle with, from its starting square
+	if ((startPos->x != HOME_ROW(isMovesForBlackPlayer)) || (startPos->y != KING_START_COLUMN))
 		return;
-	querySinglePos(board, possibleMoves, isMovesForBlackPlayer, startPos, -1, -1, startPos);
+
+	if (isCastlingPossible(board, isMovesForBlackPlayer, castlingRights, KINGSIDE_CASTLING(isMovesForBlackPlayer),
+						   KINGSIDE_ROOK_COLUMN))
+		addPossibleMove(possibleMoves, startPos, startPos->x, KING_START_COLUMN + CASTLING_KING_STEP);
+	if (isCastlingPossible(board, isMovesForBlackPlayer, castlingRights, QUEENSIDE_CASTLING(isMovesForBlackPlayer),
+						   QUEENSIDE_ROOK_COLUMN))
+		addPossibleMove(possibleMoves, startPos, startPos->x, KING_START_COLUMN - CASTLING_KING_STEP);
 }
 
 /*
 * Get all possible position / eat moves of any soldier.
 * Input:
-*		board ~ The game board.
-*		possibleMoves ~ A list of possible moves by the current player, the list will be filled with possible moves for
+*		state ~ The board state: the game board, with its castling rights and en passant square.
+*		possibleMoves ~ A buffer of possible moves by the current player, the buffer will be filled with possible moves for
 *					    the piece.
 *		isMovesForBlackPlayer ~ True if current player is black. False if white.
 *		startPos ~ Where the soldier is currently located.
-*		kingPos ~ Current position of the current player's king.
+*		occupied ~ The occupied squares of the board.
+*		own ~ The squares of the pieces of the current player.
 */
-void getPieceMove(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
-				  bool isMovesForBlackPlayer, Position* startPos, Position* kingPos)
+void getPieceMove(BoardState* state, MoveBuffer* possibleMoves, bool isMovesForBlackPlayer, Position* startPos,
+				  BitBoard occupied, BitBoard own)
 {
 	// Search for moves only if the piece on the square belongs to the current player.
-	if (isSquareOccupiedByCurrPlayer(board, isMovesForBlackPlayer, startPos->x, startPos->y))
+	if (isSquareOccupiedByCurrPlayer(state->board, isMovesForBlackPlayer, startPos->x, startPos->y))
 	{
-		switch (board[startPos->x][startPos->y]) // Get move by piece type
+		switch (state->board[startPos->x][startPos->y]) // Get move by piece type
 		{
 			case (WHITE_P):
 			case (BLACK_P):
 			{
-				getPawnMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
+				getPawnMoves(state->board, possibleMoves, isMovesForBlackPlayer, startPos, state->enPassantSquare);
 				break;
 			}
 			case (WHITE_B) :
 			case (BLACK_B) :
 			{
-				getBishopMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
+				getBishopMoves(possibleMoves, startPos, occupied, own);
 				break;
 			}
 			case (WHITE_R) :
 			case (BLACK_R) :
 			{
-				getRookMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
+				getRookMoves(possibleMoves, startPos, occupied, own);
 				break;
 			}
 			case (WHITE_N) :
 			case (BLACK_N) :
 			{
-				getKnightMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
+				getKnightMoves(state->board, possibleMoves, isMovesForBlackPlayer, startPos);
 				break;
 			}
 			case (WHITE_Q) :
 			case (BLACK_Q) :
 			{
-				getQueenMoves(board, possibleMoves, isMovesForBlackPlayer, startPos, kingPos);
+				getQueenMoves(possibleMoves, startPos, occupied, own);
 				break;
 			}
 			case (WHITE_K) :
 			case (BLACK_K) :
 			{
-				getKingMoves(board, possibleMoves, isMovesForBlackPlayer, startPos);
+				getKingMoves(state->board, possibleMoves, isMovesForBlackPlayer, startPos, state->castlingRights);
 				break;
 			}
 			default:
@@ -599,42 +352,231 @@ void getPieceMove(char board[BOARD_SIZE][BOARD_SIZE], LinkedList* possibleMoves,
 	}
 }
 
+/* Returns the occupied squares of the board, and sets own to the squares of the pieces of the given player. */
+BitBoard getBoardOccupancy(char board[BOARD_SIZE][BOARD_SIZE], bool isMovesForBlackPlayer, BitBoard* own)
+{
+	BitBoard occupied = EMPTY_BITBOARD;
+	*own = EMPTY_BITBOARD;
+
+	int square;
+	for (square = 0; square < NUM_OF_SQUARES; square++)
+	{
+		char soldier = board[SQUARE_ROW(square)][SQUARE_COLUMN(square)];
+		if (soldier == EMPTY)
+			continue;
+
+		occupied |= SQUARE_BIT(square);
+		if (isBlackSoldier(soldier) == isMovesForBlackPlayer)
+			*own |= SQUARE_BIT(square);
+	}
+
+	return occupied;
+}
+
+/*
+ * Fills the buffer with the pseudo-legal moves of the player to move: the moves its pieces can make (with double
+ * pawn pushes, captures en passant and castlings), without testing whether they leave its king in check.
+ * A move must pass isLegalMove before it is played.
+ * An empty buffer means the player has no legal moves, but not the other way round: a mated or stalemated player
+ * may still have pseudo-legal moves, so use hasLegalMove to find out whether it can move.
+ */
+void generatePseudoLegalMoves(BoardState* state, MoveBuffer* possibleMoves)
+{
+	possibleMoves->length = 0;
+
+	BitBoard own;
+	BitBoard occupied = getBoardOccupancy(state->board, state->isBlackTurn, &own);
+
+	// The pieces of the player by ascending square, the order of the rows and columns of the board
+	BitBoard pieces = own;
+	while (pieces != EMPTY_BITBOARD)
+	{
+		int square = popFirstSquare(&pieces);
+		Position startPos;
+		startPos.x = SQUARE_ROW(square);
+		startPos.y = SQUARE_COLUMN(square);
+		getPieceMove(state, possibleMoves, state->isBlackTurn, &startPos, occupied, own);
+	}
+}
+
+/*
+ * Remove the moves which leave the king of the player to move in check from the buffer, keeping the order of the
+ * rest.
+ */
+void filterLegalMoves(BoardState* state, MoveBuffer* possibleMoves)
+{
+	LegalityInfo info;
+	initLegalityInfo(state, &info);
+
+	int length = 0;
+	int i;
+	for (i = 0; i < possibleMoves->length; i++)
+	{
+		if (isLegalMove(state, possibleMoves->moves[i], &info))
+			possibleMoves->moves[length++] = possibleMoves->moves[i];
+	}
+	possibleMoves->length = length;
+}
+
 /* 
- * Iterates the board and returns a list of moves the player can make with each piece
+ * Iterates the board and fills the buffer with the moves the player to move can make with each piece.
+ * No memory is allocated, so this is safe to call at every node of the minimax tree.
  * Input:
- *		board ~ The game board.
- *		isMovesForBlackPlayer ~ True if the function returns moves for the black player.
- *							    False if the function returns moves for the white player.
+ *		state ~ The board state: the game board, the player to move, its castling rights and en passant square.
+ *		possibleMoves ~ The buffer to fill. Previous content is discarded.
  */
-LinkedList* getMoves(char board[BOARD_SIZE][BOARD_SIZE], bool isMovesForBlackPlayer)
+void generateMoves(BoardState* state, MoveBuffer* possibleMoves)
 {
-	LinkedList* possibleMoves = createList(deleteMove);  // <-- This list contains the results of moves available.
-													     // Note we change this list in the following service functions.
-	if (g_memError)
-		return NULL;
-
-	Position kingPos = getKingPosition(board, isMovesForBlackPlayer); // Position of current player's king
+	generatePseudoLegalMoves(state, possibleMoves);
+	filterLegalMoves(state, possibleMoves);
+}
 
-	int i, j; // i = row, j = column
+/*
+ * Set the legality info of the player to move, for testing its pseudo-legal moves with isLegalMove: the pieces
+ * checking its king, the squares where its other pieces can answer the check, and its pieces which are pinned to its
+ * king with their pin rays. Computed once per position, from the sliding attack tables.
+ */
+void initLegalityInfo(BoardState* state, LegalityInfo* info)
+{
+	bool isMovesForBlackPlayer = state->isBlackTurn;
+	const BitBoards* bitBoards = &(info->bitBoards);
+
+	boardToBitBoards(state->board, &(info->bitBoards));
+	info->checkers = EMPTY_BITBOARD;
+	info->evasions = EMPTY_BITBOARD;
+	info->pinned = EMPTY_BITBOARD;
+	info->isInCheck = false;
+
+	int direction;
+	for (direction = 0; direction < NUM_OF_DIRECTIONS; direction++)
+		info->pinRays[direction] = EMPTY_BITBOARD;
+
+	BitBoard king = bitBoards->pieces[isMovesForBlackPlayer][KING_TYPE];
+	if (king == EMPTY_BITBOARD)
+	{	// No king, nothing to protect
+		info->kingPos.x = INVALID_POSITION_INDEX;
+		info->kingPos.y = INVALID_POSITION_INDEX;
+		return;
+	}
 
-	for (i = 0; i < BOARD_SIZE; i++)
+	int kingSquare = getFirstSquare(king);
+	info->kingPos.x = SQUARE_ROW(kingSquare);
+	info->kingPos.y = SQUARE_COLUMN(kingSquare);
+
+	// The rays from the king through the pieces of the player, each up to the first enemy piece on it. An enemy piece
+	// moving along its ray checks the king if no piece of the player is on the way, or pins a single one.
+	const BitBoard* enemy = bitBoards->pieces[!isMovesForBlackPlayer];
+	BitBoard own = bitBoards->occupied[isMovesForBlackPlayer];
+	BitBoard diagonalRays = getBishopAttacks(kingSquare, bitBoards->occupied[!isMovesForBlackPlayer]);
+	BitBoard lineRays = getRookAttacks(kingSquare, bitBoards->occupied[!isMovesForBlackPlayer]);
+	for (direction = 0; direction < NUM_OF_DIRECTIONS; direction++)
 	{
-		for (j = 0; j < BOARD_SIZE; j++)
+		bool isDiagonal = ((g_directions[direction][0] != 0) && (g_directions[direction][1] != 0));
+		BitBoard ray = (isDiagonal ? diagonalRays : lineRays) & g_rayMasks[direction][kingSquare];
+		BitBoard threat = ray & (enemy[QUEEN_TYPE] | enemy[isDiagonal ? BISHOP_TYPE : ROOK_TYPE]);
+		if (threat == EMPTY_BITBOARD)
+			continue;
+
+		BitBoard shields = ray & own;
+		if (shields == EMPTY_BITBOARD)
+		{
+			info->checkers |= threat;
+			info->evasions |= ray;	// Capture the checker or block its line
+		}
+		else if ((shields & (shields - 1)) == EMPTY_BITBOARD)
 		{
-			Position startPos;
-			startPos.x = i;
-			startPos.y = j;
-			getPieceMove(board, possibleMoves, isMovesForBlackPlayer, &startPos, &kingPos);
+			info->pinned |= shields;
+			info->pinRays[direction] = ray;	// The pinned piece may only move along the ray
+		}
+	}
 
-			if (g_memError)
-			{
-				deleteList(possibleMoves);
-				return NULL;
-			}
+	// Knights and pawns check from a single square, which can only be answered by capturing them
+	BitBoard leapers = (getKnightAttacks(kingSquare) & enemy[KNIGHT_TYPE]) |
+					   (getPawnAttacks(kingSquare, isMovesForBlackPlayer) & enemy[PAWN_TYPE]);
+	info->checkers |= leapers;
+	info->evasions |= leapers;
+
+	// In double check only the king can move
+	if (countBits(info->checkers) > 1)
+		info->evasions = EMPTY_BITBOARD;
+	info->isInCheck = (info->checkers != EMPTY_BITBOARD);
+}
+
+/*
+ * Returns if the pseudo-legal move of the player doesn't leave its king in check.
+ * Moves of the other pieces are decided by the masks of the legality info, without touching the board: in check they
+ * must capture the checker or block its line, and a pinned piece must stay on its pin ray.
+ * Moves of the king are tested for attacks on their target square (and the square it passes when castling), and
+ * captures en passant are played on a copy of the bitboards of the board.
+ * Input:
+ *		state ~ The board state of the player to move.
+ *		move ~ A move of generatePseudoLegalMoves.
+ *		info ~ The legality info of the player (see initLegalityInfo).
+ */
+bool isLegalMove(BoardState* state, CompactMove move, LegalityInfo* info)
+{
+	bool isMovesForBlackPlayer = state->isBlackTurn;
+	int start = MOVE_START_SQUARE(move);
+	int target = MOVE_TARGET_SQUARE(move);
+	bool isKingMove = ((SQUARE_ROW(start) == info->kingPos.x) && (SQUARE_COLUMN(start) == info->kingPos.y));
+	bool isEnPassant = ((target == state->enPassantSquare) && (SQUARE_COLUMN(target) != SQUARE_COLUMN(start)) &&
+						(getPieceType(state->board[SQUARE_ROW(start)][SQUARE_COLUMN(start)]) == PAWN_TYPE));
+
+	if (isKingMove)
+	{
+		int deltaY = SQUARE_COLUMN(target) - SQUARE_COLUMN(start);
+		if ((deltaY == CASTLING_KING_STEP) || (deltaY == -CASTLING_KING_STEP))
+		{	// The king may not castle out of check, nor through or into an attacked square
+			return (!info->isInCheck) &&
+				   (!isSquareAttacked(&(info->bitBoards), start + (deltaY / 2), !isMovesForBlackPlayer)) &&
+				   (!isSquareAttacked(&(info->bitBoards), target, !isMovesForBlackPlayer));
 		}
+
+		// The king must not step onto an attacked square. The square it leaves no longer blocks the enemy rays
+		return !isSquareAttackedThrough(&(info->bitBoards), target, !isMovesForBlackPlayer,
+										info->bitBoards.all & ~SQUARE_BIT(start));
 	}
 
-	return possibleMoves;
+	if (isEnPassant)
+	{	// Two pawns leave the row of the king at once, so the pins don't tell: play the capture on the bitboards
+		BitBoards after = info->bitBoards;
+		BitBoard moved = SQUARE_BIT(start) | SQUARE_BIT(target);
+		BitBoard removed = SQUARE_BIT(SQUARE_INDEX(SQUARE_ROW(start), SQUARE_COLUMN(target)));
+		after.pieces[isMovesForBlackPlayer][PAWN_TYPE] ^= moved;
+		after.occupied[isMovesForBlackPlayer] ^= moved;
+		after.pieces[!isMovesForBlackPlayer][PAWN_TYPE] ^= removed;
+		after.occupied[!isMovesForBlackPlayer] ^= removed;
+		after.all ^= moved | removed;
+		return !isBitBoardKingUnderCheck(&after, isMovesForBlackPlayer);
+	}
+
+	if (info->isInCheck && ((info->evasions & SQUARE_BIT(target)) == EMPTY_BITBOARD))
+		return false;
+
+	if ((info->pinned & SQUARE_BIT(start)) != EMPTY_BITBOARD)
+	{
+		int direction;
+		for (direction = 0; direction < NUM_OF_DIRECTIONS; direction++)
+		{
+			if ((info->pinRays[direction] & SQUARE_BIT(start)) != EMPTY_BITBOARD)
+				return ((info->pinRays[direction] & SQUARE_BIT(target)) != EMPTY_BITBOARD);
+		}
+	}
+
+	return true;
+}
+
+/* Returns true if any of the pseudo-legal moves of the player to move in the buffer is legal (see isLegalMove). */
+bool hasLegalMove(BoardState* state, const MoveBuffer* possibleMoves, LegalityInfo* info)
+{
+	int i;
+	for (i = 0; i < possibleMoves->length; i++)
+	{
+		if (isLegalMove(state, possibleMoves->moves[i], info))
+			return true;
+	}
+
+	return false;
 }
 
 /*
@@ -643,15 +585,16 @@ LinkedList* getMoves(char board[BOARD_SIZE][BOARD_SIZE], bool isMovesForBlackPla
  */
 bool isCheck(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer)
 {
-	Position kingPos = getKingPosition(board, isTestForBlackPlayer);
-	return isKingUnderCheck(board, isTestForBlackPlayer, &kingPos);
+	BitBoards bitBoards;
+	boardToBitBoards(board, &bitBoards);
+	return isBitBoardKingUnderCheck(&bitBoards, isTestForBlackPlayer);
 }
 
 /** Returns if the black player (isTestForBlackPlayer-true) or white player (isTestForBlackPlayer=false)
  *	are in Matt (their king is in danger and cannot be saved).
  *	To optimize, this method accepts possibleMoves for the given player, to avoid calculating them all over again.
  */
-bool isMatt(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, LinkedList* possibleMoves)
+bool isMatt(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, const MoveBuffer* possibleMoves)
 {
 	return ((possibleMoves->length == 0) && (isCheck(board, isTestForBlackPlayer)));
 }
@@ -660,7 +603,7 @@ bool isMatt(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Linke
 *	are in tie (their king is not in danger but no additional moves can be made).
 *	To optimize, this method accepts possibleMoves for the given player, to avoid calculating them all over again.
 */
-bool isTie(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, LinkedList* possibleMoves)
+bool isTie(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, const MoveBuffer* possibleMoves)
 {
 	return ((possibleMoves->length == 0) && (!isCheck(board, isTestForBlackPlayer)));
 }
@@ -671,31 +614,59 @@ bool isTie(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, Linked
 * Otherwise we query the square to find out which player occupies the square, and returns the possible moves for that
 * player's piece.
 * Input:
-*		board ~ The game board.
+*		state ~ The board state: the game board, with its castling rights and en passant square.
 *		x, y ~ The position on board to search for moves.
 */
-LinkedList* getMovesForSquare(char board[BOARD_SIZE][BOARD_SIZE], int x, int y)
+LinkedList* getMovesForSquare(BoardState* state, int x, int y)
 {
 	LinkedList* possibleMoves = createList(deleteMove);  // <-- This list contains the results of moves available.
-														 // Note we change this list in the following service functions.
 	if (g_memError)
 		return NULL;
 
-	if (!isSquareOnBoard(x, y) || isSquareVacant(board, x, y))
+	if (!isSquareOnBoard(x, y) || isSquareVacant(state->board, x, y))
 		return possibleMoves;
 
-	bool isMovesForBlackPlayer = isSquareOccupiedByBlackPlayer(board, x, y);
+	// The moves are of the player of the piece. The en passant square belongs to the player to move only
+	bool isMovesForBlackPlayer = isSquareOccupiedByBlackPlayer(state->board, x, y);
+	BoardState pieceState = *state;
+	if (pieceState.isBlackTurn != isMovesForBlackPlayer)
+	{
+		pieceState.isBlackTurn = isMovesForBlackPlayer;
+		pieceState.enPassantSquare = NO_EN_PASSANT_SQUARE;
+	}
 
-	Position kingPos = getKingPosition(board, isMovesForBlackPlayer); // Position of current player's king
 	Position startPos;
 	startPos.x = x;
 	startPos.y = y;
-	getPieceMove(board, possibleMoves, isMovesForBlackPlayer, &startPos, &kingPos);
 
-	if (g_memError)
+	BitBoard own;
+	BitBoard occupied = getBoardOccupancy(state->board, isMovesForBlackPlayer, &own);
+
+	MoveBuffer squareMoves;
+	squareMoves.length = 0;
+	getPieceMove(&pieceState, &squareMoves, isMovesForBlackPlayer, &startPos, occupied, own);
+	filterLegalMoves(&pieceState, &squareMoves);
+
+	// Convert the moves to the list form used by the console and gui
+	int i;
+	for (i = 0; i < squareMoves.length; i++)
 	{
-		deleteList(possibleMoves);
-		return NULL;
+		Move decodedMove = decodeMove(squareMoves.moves[i], isMovesForBlackPlayer);
+		Move* newMove = createMove(&decodedMove.initPos, &decodedMove.nextPos);
+		if (g_memError)
+		{
+			deleteList(possibleMoves);
+			return NULL;
+		}
+		newMove->promotion = decodedMove.promotion;
+
+		insertLast(possibleMoves, newMove);
+		if (g_memError)
+		{
+			deleteMove((void*)newMove);
+			deleteList(possibleMoves);
+			return NULL;
+		}
 	}
 
 	return possibleMoves;
@@ -4,6 +4,24 @@
 #include <stdio.h>
 #include "LinkedList.h"
 #include "Types.h"
+#include "BoardManager.h"
+#include "BitBoard.h"
+
+/*
+ * What the legality test of the pseudo-legal moves needs to know of the player to move (see initLegalityInfo).
+ * Computed once per position, so only the moves of the king have to be tested for attacks.
+ */
+typedef struct
+{
+	Position kingPos;						// Position of the king of the player
+	bool isInCheck;							// True if the player is in check
+	BitBoard checkers;						// The enemy pieces checking the king
+	BitBoard evasions;						// The squares a piece other than the king can answer the check on
+	BitBoard pinned;						// The pieces of the player pinned to its king
+	BitBoard pinRays[NUM_OF_DIRECTIONS];	// Per direction from the king: the squares up to the pinning piece
+	BitBoards bitBoards;					// The bitboards of the board, for the checks and pins, and the attack
+											// tests of the king moves and of the captures en passant
+} LegalityInfo;
 
 /*
  * Get all possible moves for the given square.
@@ -11,19 +29,51 @@
  * Otherwise we query the square to find out which player occupies the square, and returns the possible moves for that
  * player's piece.
  * Input:
- *		board ~ The game board.
+ *		state ~ The board state: the game board, with its castling rights and en passant square.
  *		x, y ~ The position on board to search for moves.
  */
-LinkedList* getMovesForSquare(char board[BOARD_SIZE][BOARD_SIZE], int x, int y);
+LinkedList* getMovesForSquare(BoardState* state, int x, int y);
+
+/*
+ * Iterates the board and fills the buffer with the moves the player to move can make with each piece.
+ * No memory is allocated, so this is safe to call at every node of the minimax tree.
+ * Input:
+ *		state ~ The board state: the game board, the player to move, its castling rights and en passant square.
+ *		possibleMoves ~ The buffer to fill. Previous content is discarded.
+ */
+void generateMoves(BoardState* state, MoveBuffer* possibleMoves);
 
 /*
- * Iterates the board and returns a list of moves the player can make with each piece
+ * Fills the buffer with the pseudo-legal moves of the player to move: the moves its pieces can make (with double
+ * pawn pushes, captures en passant and castlings), without testing whether they leave its king in check.
+ * A move must pass isLegalMove before it is played.
+ * An empty buffer means the player has no legal moves, but not the other way round: a mated or stalemated player
+ * may still have pseudo-legal moves, so use hasLegalMove to find out whether it can move.
+ */
+void generatePseudoLegalMoves(BoardState* state, MoveBuffer* possibleMoves);
+
+/*
+ * Set the legality info of the player to move, for testing its pseudo-legal moves with isLegalMove: the pieces
+ * checking its king, the squares where its other pieces can answer the check, and its pieces which are pinned to its
+ * king with their pin rays. Computed once per position, from the sliding attack tables.
+ */
+void initLegalityInfo(BoardState* state, LegalityInfo* info);
+
+/*
+ * Returns if the pseudo-legal move of the player to move doesn't leave its king in check.
+ * Moves of the other pieces are decided by the masks of the legality info, without touching the board: in check they
+ * must capture the checker or block its line, and a pinned piece must stay on its pin ray.
+ * Moves of the king are tested for attacks on their target square (and the square it passes when castling), and
+ * captures en passant are played on a copy of the bitboards of the board.
  * Input:
- *		board ~ The game board.
- *		isMovesForBlackPlayer ~ True if the function returns moves for the black player.
- *							    False if the function returns moves for the white player.
+ *		state ~ The board state of the player to move.
+ *		move ~ A move of generatePseudoLegalMoves.
+ *		info ~ The legality info of the player (see initLegalityInfo).
  */
-LinkedList* getMoves(char board[BOARD_SIZE][BOARD_SIZE], bool isMovesForBlackPlayer);
+bool isLegalMove(BoardState* state, CompactMove move, LegalityInfo* info);
+
+/* Returns true if any of the pseudo-legal moves of the player to move in the buffer is legal (see isLegalMove). */
+bool hasLegalMove(BoardState* state, const MoveBuffer* possibleMoves, LegalityInfo* info);
 
 /*
  * Returns either whether the black player (isTestForBlackPlayer == true) is in check,
@@ -35,12 +85,12 @@ bool isCheck(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer);
  *	are in Matt (their king is in danger and cannot be saved).
  *	To optimize, this method accepts possibleMoves for the given player, to avoid calculating them all over again.
  */
-bool isMatt(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, LinkedList* possibleMoves);
+bool isMatt(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, const MoveBuffer* possibleMoves);
 
 /* Returns if the black player (isTestForBlackPlayer-true) or white player (isTestForBlackPlayer=false)
  *	are in tie (their king is not in danger but no additional moves can be made).
  *	To optimize, this method accepts possibleMoves for the given player, to avoid calculating them all over again.
  */
-bool isTie(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, LinkedList* possibleMoves);
+bool isTie(char board[BOARD_SIZE][BOARD_SIZE], bool isTestForBlackPlayer, const MoveBuffer* possibleMoves);
 
 #endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "GuiFW.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
 #include <limits.h>
 
 //  ---------------------------------------
@@ -57,6 +59,7 @@ void drawPanel(void* component, const Rectangle* const container);
 void drawButton(void* component, const Rectangle* const container);
 void drawImage(void* component, const Rectangle* const container);
 void drawAnimation(void* component, const Rectangle* const container);
+void drawLabel(void* component, const Rectangle* const container);
 void drawDialog(void* component, const Rectangle* const container);
 void destroyGuiComponentWrapper(void* wrapper);
 void destroyWindow(void* component);
@@ -64,6 +67,7 @@ void destroyButton(void* component);
 void destroyImage(void* component);
 void destroyPanel(void* component);
 void destroyAnimation(void* component);
+void destroyLabel(void* component);
 void destroyDialog(void* component);
 void destroyDialogButton(void* component);
 void removeComponentFromParent(GuiComponentWrapper* wrapper);
@@ -115,6 +119,12 @@ GuiGeneralProperties* getComponentGeneralProperties(GuiComponentWrapper* compone
 			properties = &animation->generalProperties;
 			break;
 		}
+		case(LABEL) :
+		{
+			GuiLabel* label = (GuiLabel*)componentWrapper->component;
+			properties = &label->generalProperties;
+			break;
+		}
 		case(DIALOG) :
 		{
 			GuiDialog* dialog = (GuiDialog*)componentWrapper->component;
@@ -230,6 +240,20 @@ void addChildComponent(GuiComponentWrapper* wrapper, GuiComponentWrapper* parent
 			animation->clips = (GuiImage*)wrapper->component; // Attach son to specific field
 			break;
 		}
+		case(LABEL) :
+		{
+			GuiLabel* label = (GuiLabel*)parent->component;
+
+			if (IMAGE != wrapper->type)
+			{
+				printf("Error: Invalid state. Label can only have image son components");
+				g_guiError = true;
+				break;
+			}
+
+			label->font = (GuiImage*)wrapper->component; // Attach son to specific field
+			break;
+		}
 		case(DIALOG) :
 		{
 			GuiDialog* dialog = (GuiDialog*)parent->component;
@@ -528,6 +552,73 @@ GuiAnimation* createAnimation(GuiComponentWrapper* parent, Rectangle bounds, sho
 	return animation;
 }
 
+/** Sets the text shown by the label. Text longer than MAX_LABEL_TEXT is cut. */
+void setLabelText(GuiLabel* label, const char* text)
+{
+	strncpy(label->text, text, MAX_LABEL_TEXT - 1);
+	label->text[MAX_LABEL_TEXT - 1] = '\0';
+}
+
+/** Creates a new label in the Gui FW, with an empty text. On error, NULL is returned.
+ *  parent - Control that contains this new control.
+ *  bounds - position and dimensions of the control. Text that doesn't fit in the bounds is cut.
+ *	zOrder - Sorts which control shows in front of which, the higher z order the closer the control is to the user.
+ *  fontSourcePath - relative path of the bitmap that contains the glyphs of the characters.
+ *	transparentColor - The color that represents transparency in the bitmap.
+ *	characters - The characters of the glyphs in the bitmap, in order (a preallocated string).
+ *	glyphWidth, glyphHeight - Dimensions of a single glyph within the font bitmap.
+ */
+GuiLabel* createLabel(GuiComponentWrapper* parent, Rectangle bounds, short zOrder,
+					  const char* fontSourcePath, GuiColorRGB transparentColor,
+					  const char* characters, int glyphWidth, int glyphHeight)
+{
+	if (NULL == parent)
+	{
+		printf("Error: NULL parent given to new label component");
+		return NULL;
+	}
+
+	GuiLabel* label = (GuiLabel*)malloc(sizeof(GuiLabel));
+	if (NULL == label)
+	{
+		printf("Error: standard function malloc has failed");
+		return NULL;
+	}
+
+	// Set "control properties"
+	label->generalProperties.bounds = bounds;
+	label->generalProperties.parent = parent;
+	label->generalProperties.zOrder = zOrder;
+	label->generalProperties.window = getComponentGeneralProperties(parent)->window;
+	label->generalProperties.isVisible = true;
+	Rectangle emptyBounds = { 0, 0, 0, 0 };
+	label->generalProperties.visibleBounds = emptyBounds; // Will be calculated on first draw
+	label->generalProperties.extent = NULL;
+	label->characters = characters;
+	label->glyphWidth = glyphWidth;
+	label->glyphHeight = glyphHeight;
+	label->text[0] = '\0';
+	Rectangle fontBounds = { 0, 0, glyphWidth * (int)strlen(characters), glyphHeight };
+	label->generalProperties.wrapper = createControlWrapper(label, LABEL);
+	if (NULL == label->generalProperties.wrapper)
+	{
+		return NULL;
+	}
+
+	// Create font image son component. It will link itself to the label parent.
+	createImage(label->generalProperties.wrapper, fontBounds, zOrder, fontSourcePath, transparentColor);
+
+	// Set "control methods"
+	label->generalProperties.draw = drawLabel;
+	label->generalProperties.destroy = destroyLabel;
+	label->setText = setLabelText;
+
+	// Attach the label to its parent.
+	addChildComponent(label->generalProperties.wrapper, parent);
+
+	return label;
+}
+
 /** Creates a new button in the Gui FW. On error, NULL is returned.
  *  parent - Control that contains this new control.
  *  bounds - position and dimensions of the control.
@@ -985,6 +1076,18 @@ void destroyAnimation(void* component)
 	free(animation);
 }
 
+/** Destructor for Gui labels. */
+void destroyLabel(void* component)
+{
+	if (NULL == component)
+		return;
+
+	GuiLabel* label = (GuiLabel*)component;
+
+	destroyGuiComponentWrapper(label->font->generalProperties.wrapper);
+	free(label);
+}
+
 /** Destructor for Gui dialogs. */
 void destroyDialogButton(void* component)
 {
@@ -1367,6 +1470,50 @@ void drawAnimation(void* component, const Rectangle* const container)
 	animation->generalProperties.visibleBounds = animation->clips->generalProperties.visibleBounds;
 }
 
+/** Draws the label, glyph by glyph. Glyphs are positioned relative to the label and cut by its bounds. */
+void drawLabel(void* component, const Rectangle* const container)
+{
+	GuiLabel* label = (GuiLabel*)component;
+
+	if (!label->generalProperties.isVisible)
+		return; // Avoid drawing invisible controls
+
+	const Rectangle absoluteBounds = getAbsoluteBounds(&label->generalProperties.bounds, container);
+	label->generalProperties.visibleBounds = absoluteBounds; // Keep results in visibleBounds
+
+	GuiImage* font = label->font;
+	font->scissorRegion.y = 0;
+	font->scissorRegion.width = label->glyphWidth;
+	font->scissorRegion.height = label->glyphHeight;
+
+	int row = 0;
+	int column = 0;
+	const char* currChar;
+	for (currChar = label->text; *currChar != '\0'; currChar++)
+	{
+		if ('\n' == *currChar)
+		{ // Start a new line
+			row++;
+			column = 0;
+			continue;
+		}
+
+		// Characters missing in the font are left blank
+		const char* glyph = strchr(label->characters, toupper((unsigned char)*currChar));
+		if (NULL != glyph)
+		{ // Scissor the glyph of the character and place it in the text
+			font->scissorRegion.x = (int)(glyph - label->characters) * label->glyphWidth;
+			font->generalProperties.bounds.x = column * label->glyphWidth;
+			font->generalProperties.bounds.y = row * label->glyphHeight;
+
+			// The image deals with fitting inside the label
+			drawImage(font, &absoluteBounds);
+		}
+
+		column++;
+	}
+}
+
 /** Draws the dialog and all sub components inside it. */
 void drawDialog(void* component, const Rectangle* const container)
 {
@@ -25,6 +25,7 @@ typedef enum
 	BUTTON,
 	IMAGE,
 	ANIMATION,
+	LABEL,
 	DIALOG,
 	DIALOG_BUTTON // Dialog buttons are merely buttons, but handled a little bit differently in terms of mem managment
 } GuiComponentType;
@@ -177,6 +178,25 @@ struct GuiAnimation
 };
 typedef struct GuiAnimation GuiAnimation;
 
+#define MAX_LABEL_TEXT 256 // Maximum length of a label's text, including the null terminator
+
+/** A label in the Gui FW shows text, drawn character by character from a font image.
+ *	The font image holds a glyph for each of the label's characters in a single row, each glyph glyphWidth wide and as
+ *	high as the image. Characters missing in the font are drawn as blank glyphs and '\n' starts a new line.
+ *	Lower case letters are drawn with the glyphs of their upper case letters.
+ */
+struct GuiLabel
+{
+	GuiGeneralProperties generalProperties;
+	GuiImage* font;
+	const char* characters; // The characters of the glyphs in the font image, in order. Preallocated by the user
+	int glyphWidth, glyphHeight;
+	char text[MAX_LABEL_TEXT];
+
+	void(*setText)(struct GuiLabel* label, const char* text);
+};
+typedef struct GuiLabel GuiLabel;
+
 /** A modal dialog of generic options, opened above all components and blocks until the user makes a choice.
 */
 struct GuiDialog
@@ -279,6 +299,19 @@ GuiAnimation* createAnimation(GuiComponentWrapper* parent, Rectangle bounds, sho
 							  int timeBetweenFramesMs, bool isRepeated,
 							  void(*onAnimationEnd)(GuiAnimation* animation));
 
+/** Creates a new label in the Gui FW, with an empty text. On error, NULL is returned.
+ *  parent - Control that contains this new control.
+ *  bounds - position and dimensions of the control. Text that doesn't fit in the bounds is cut.
+ *	zOrder - Sorts which control shows in front of which, the higher z order the closer the control is to the user.
+ *  fontSourcePath - relative path of the bitmap that contains the glyphs of the characters.
+ *	transparentColor - The color that represents transparency in the bitmap.
+ *	characters - The characters of the glyphs in the bitmap, in order (a preallocated string).
+ *	glyphWidth, glyphHeight - Dimensions of a single glyph within the font bitmap.
+ */
+GuiLabel* createLabel(GuiComponentWrapper* parent, Rectangle bounds, short zOrder,
+					  const char* fontSourcePath, GuiColorRGB transparentColor,
+					  const char* characters, int glyphWidth, int glyphHeight);
+
 /** Creates a new button in the Gui FW. On error, NULL is returned.
  *  parent - Control that contains this new control.
  *  bounds - position and dimensions of the control.
@@ -337,6 +370,9 @@ void showWindow(GuiWindow* window);
 /** Restarts an animation to the first clip. */
 void restartAnimation(GuiAnimation* animation);
 
+/** Sets the text shown by the label. Text longer than MAX_LABEL_TEXT is cut. */
+void setLabelText(GuiLabel* label, const char* text);
+
 /** Queries which SDL events have happened and prompts corresponding events in the Gui FW.
  *  (e.g: GuiButton was clicked).
  */
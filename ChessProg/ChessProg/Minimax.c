@@ -1,232 +1,1101 @@
+#include <stdlib.h>
 #include <limits.h>
 #include "BoardManager.h"
 #include "GameLogic.h"
 #include "Minimax.h"
+#include "TranspositionTable.h"
+#include "ParallelSearch.h"
 
-/* Compute the total score of the given board and player. */
-int getScore(char board[BOARD_SIZE][BOARD_SIZE], bool isABlack)
+/* Returns the score of the search in pawns, rounded to the nearest pawn (the unit of the scores shown to the user). */
+int getPawnScore(int score)
 {
-	Army whiteArmy = getArmy(board, false);
-	int whiteScore = (whiteArmy.pawns * PAWN_SCORE) + (whiteArmy.bishops * BISHOP_SCORE) + (whiteArmy.rooks * ROOK_SCORE)
-					 + (whiteArmy.knights * KNIGHT_SCORE) + (whiteArmy.queens * QUEEN_SCORE) + (whiteArmy.kings * KING_SCORE);
-	Army blackArmy = getArmy(board, true);
-	int blackScore = (blackArmy.pawns * PAWN_SCORE) + (blackArmy.bishops * BISHOP_SCORE) + (blackArmy.rooks * ROOK_SCORE)
-					 + (blackArmy.knights * KNIGHT_SCORE) + (blackArmy.queens * QUEEN_SCORE) + (blackArmy.kings * KING_SCORE);
-	
-	if (!isABlack)
-	{	// White turn
-		return (whiteScore - blackScore);
+	if (score < 0)
+		return -((-score + (PAWN_SCORE / 2)) / PAWN_SCORE);
+	else
+		return (score + (PAWN_SCORE / 2)) / PAWN_SCORE;
+}
+
+/* Reset the search context before a new search of the given depth, with no limits and all the search features. */
+void initSearchContext(SearchContext* context, int depth)
+{
+	context->ply = 0;
+	context->depth = depth;
+	context->maxDepth = depth;
+	context->nodes = 0;
+	context->qnodes = 0;
+	context->nodeLimit = 0;
+	context->endTime = 0;
+	context->isStopped = false;
+	context->isMoveOrdering = true;
+	context->isQuiescence = true;
+	context->isPvs = true;
+	context->isAspiration = true;
+	context->isNullMovePruning = true;
+	context->isLateMoveReduction = true;
+	context->evaluate = g_evaluators[DEFAULT_EVALUATOR].evaluate;
+	context->lazySmp = NULL;
+	context->isError = false;
+	clearTranspositionTableStats(&(context->ttStats));
+	context->pvLengths[0] = 0;
+	context->numOfLines = 0;
+	context->info.length = 0;
+	context->info.numOfLines = 0;
+	context->info.score = 0;
+	context->info.depth = 0;
+	context->info.nodes = 0;
+	context->info.qnodes = 0;
+	context->info.timeInMs = 0;
+
+	int i;
+	for (i = 0; i < MAX_SEARCH_PLY; i++)
+		clearKillerMoves(&(context->killers[i]));
+	clearHistoryTable(&(context->history));
+}
+
+/* Limit the search to the given time (from now) and number of boards. 0 means no limit. */
+void setSearchLimits(SearchContext* context, int timeLimitMs, unsigned long long nodeLimit)
+{
+	context->endTime = (timeLimitMs > 0) ? (getTimeInMs() + timeLimitMs) : 0;
+	context->nodeLimit = nodeLimit;
+}
+
+/*
+ * Returns true if the search reached one of its limits, or the Lazy SMP search it helps is done.
+ * The clock and the Lazy SMP search are only checked once every TIME_CHECK_INTERVAL boards.
+ */
+bool isSearchStopped(SearchContext* context)
+{
+	if (context->isStopped)
+		return true;
+
+	if ((context->nodeLimit > 0) && (context->nodes >= context->nodeLimit))
+		context->isStopped = true;
+	else if ((context->nodes & (TIME_CHECK_INTERVAL - 1)) != 0)
+		return false;
+	else if ((context->endTime > 0) && (getTimeInMs() >= context->endTime))
+		context->isStopped = true;
+	else if ((context->lazySmp != NULL) && isLazySmpStopped(context->lazySmp))
+		context->isStopped = true;
+
+	return context->isStopped;
+}
+
+/* Execute the move on the board state and push its undo information to the undo stack of the search context. */
+void makeMove(SearchContext* context, BoardState* state, CompactMove move)
+{
+	GameStep* step = &(context->steps[context->ply]);
+	initGameStep(state->board, move, step);
+	doStep(state, step);
+
+	context->nullSteps[context->ply] = false;
+	context->ply++;
+	context->nodes++;
+}
+
+/* Undo the last move done with makeMove and pop it from the undo stack of the search context. */
+void unmakeMove(SearchContext* context, BoardState* state)
+{
+	context->ply--;
+	undoStep(state, &(context->steps[context->ply]));
+}
+
+/* Pass the turn on the board state (see doNullStep) as a move of the search. */
+void makeNullMove(SearchContext* context, BoardState* state)
+{
+	doNullStep(state, &(context->steps[context->ply]));
+
+	context->nullSteps[context->ply] = true;
+	context->ply++;
+	context->nodes++;
+}
+
+/* Undo the null move done with makeNullMove. */
+void unmakeNullMove(SearchContext* context, BoardState* state)
+{
+	context->ply--;
+	undoNullStep(state, &(context->steps[context->ply]));
+}
+
+/* Move the given move to the front of the buffer (if it is in the buffer), so it is searched first. */
+void moveToFront(MoveBuffer* moves, CompactMove move)
+{
+	int i;
+	for (i = 0; i < moves->length; i++)
+	{
+		if (moves->moves[i] == move)
+		{
+			moves->moves[i] = moves->moves[0];
+			moves->moves[0] = move;
+			return;
+		}
+	}
+}
+
+/* Remember a quiet move that caused a cutoff with the given number of plies left, for ordering the next searches. */
+void addCutoffMove(SearchContext* context, bool isABlack, CompactMove move, int depth)
+{
+	addKillerMove(&(context->killers[context->ply]), move);
+	addHistoryMove(&(context->history), isABlack, move, depth);
+}
+
+/* Make the move, followed by the best line of the next ply, the best line of the current ply of the search. */
+void updatePrincipalVariation(SearchContext* context, CompactMove move)
+{
+	int ply = context->ply;
+	CompactMove* line = context->pvTable[ply];
+	const CompactMove* childLine = context->pvTable[ply + 1];
+
+	line[ply] = move;
+	int i;
+	for (i = ply + 1; i < context->pvLengths[ply + 1]; i++)
+		line[i] = childLine[i];
+	context->pvLengths[ply] = maxi(context->pvLengths[ply + 1], ply + 1);
+}
+
+/*
+ * Returns the score of a board where the player to move has no moves: mate if the player is in check, else a tie.
+ * The score is for the root player, as for the parent level in the tree.
+ */
+int getNoMovesScore(char board[BOARD_SIZE][BOARD_SIZE], bool isABlack, bool isMaxTurn)
+{
+	if (isCheck(board, isABlack))
+		return isMaxTurn ? LOOSING_SCORE : WINNING_SCORE;	// Mate
+	else
+		return isMaxTurn ? TIE_SCORE_ABS : -TIE_SCORE_ABS;	// Tie. Worst score, except for loosing, for the parent
+}
+
+/* Returns how much the score of the player grows by the capture or promotion. */
+int getCaptureGain(BoardState* state, CompactMove move)
+{
+	int gain = getPieceTypeScore(getCapturedType(state, move));
+	if (MOVE_PROMOTION_TYPE(move) != NO_PROMOTION_TYPE)
+		gain += getPieceTypeScore(MOVE_PROMOTION_TYPE(move)) - PAWN_SCORE;
+
+	return gain;
+}
+
+/*
+ * The quiescence search at the leaves of the minimax tree: only captures and promotions are searched, until the
+ * board is quiet, so a leaf is never scored in the middle of an exchange.
+ * The player to move may also stop capturing (stand pat), so the score of the board bounds its result. Captures
+ * that can't bring the score back into the window even with a spare margin are skipped (delta pruning).
+ * A player in check may not stand pat: all its evasions are searched, and without one it is mate. Out of check, a
+ * tie (no legal moves) is only told apart when no capture was searched, so most boards skip the test.
+ * Results are not kept in the transposition table.
+ */
+int quiescence(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack)
+{
+	context->pvLengths[context->ply] = context->ply;	// No best line yet
+	if (isSearchStopped(context))
+		return 0;
+
+	bool isMaxTurn = ((level % 2) == 0);
+	MoveBuffer* moves = &(context->moves[context->ply]);
+	LegalityInfo legality;
+	generatePseudoLegalMoves(state, moves);
+	initLegalityInfo(state, &legality);
+	bool isInCheck = legality.isInCheck;
+
+	// Stand pat, with the score according to the color of the root of the minimax
+	int standPat = context->evaluate(state, isMaxTurn ? isABlack : !isABlack);
+	if (context->ply >= MAX_SEARCH_PLY - 1)
+		return standPat;	// No room left in the undo stack
+
+	int value = isMaxTurn ? INT_MIN : INT_MAX;
+	if (!isInCheck)
+	{
+		value = standPat;
+		if (isMaxTurn)
+			alpha = maxi(alpha, standPat);
+		else
+			beta = mini(beta, standPat);
+		if (beta <= alpha)
+			return standPat;
+	}
+
+	// Captures and promotions come first, by MVV-LVA
+	orderMoves(state, moves, isABlack, NO_MOVE, NULL, NULL);
+
+	bool isMoveSearched = false;
+	int result, gain;
+	int i;
+	for (i = 0; (i < moves->length) && (beta > alpha); i++)
+	{
+		if ((!isInCheck) && isQuietMove(state, moves->moves[i]))
+			break;	// Only quiet moves are left
+
+		// Delta pruning
+		gain = getCaptureGain(state, moves->moves[i]);
+		if ((!isInCheck) && (isMaxTurn ? (standPat + gain + QUIESCENCE_DELTA_MARGIN <= alpha)
+									   : (standPat - gain - QUIESCENCE_DELTA_MARGIN >= beta)))
+			continue;
+
+		if (!isLegalMove(state, moves->moves[i], &legality))
+			continue;
+
+		isMoveSearched = true;
+		makeMove(context, state, moves->moves[i]);
+		context->qnodes++;
+		result = quiescence(context, state, level + 1, alpha, beta, !isABlack);
+		unmakeMove(context, state);
+
+		if (isMaxTurn)
+		{	// Max turn
+			value = maxi(value, result);
+			if (alpha < value)
+			{
+				alpha = value;
+				updatePrincipalVariation(context, moves->moves[i]);
+			}
+		}
+		else
+		{	// Min turn
+			value = mini(value, result);
+			if (beta > value)
+			{
+				beta = value;
+				updatePrincipalVariation(context, moves->moves[i]);
+			}
+		}
+	}
+
+	// In check all the legal moves were searched. Out of check, a legal move ends the search before the tie test
+	if ((!isMoveSearched) && (isInCheck || (!hasLegalMove(state, moves, &legality))))
+		return getNoMovesScore(state->board, isABlack, isMaxTurn);
+
+	return value;
+}
+
+/*
+ * Returns true if the player has pieces other than pawns and the king. Without them zugzwang is common (every move
+ * makes things worse), so passing the turn tells nothing about the moves of the player. O(1), from the game phase
+ * of the player.
+ */
+bool hasPieces(BoardState* state, bool isBlackPlayer)
+{
+	return (state->phase[isBlackPlayer] > 0);	// Only the pieces count in the game phase
+}
+
+/* Search the board of the given level as alphabeta does, with the given number of plies less below it. */
+int alphabetaReduced(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack,
+					 int reduction)
+{
+	// The plies left below a board are counted from the depth of the tree, so the tree is made shallower meanwhile
+	context->depth -= reduction;
+	int value = alphabeta(context, state, level, alpha, beta, isABlack);
+	context->depth += reduction;
+
+	return value;
+}
+
+/*
+ * Late move reduction: a quiet move ordered late is unlikely to be better than the moves before it, so it is first
+ * searched LMR_REDUCTION plies shallower with a null window at the bound of the parent. Only a move that beats the
+ * bound anyway is searched as usual (see searchChild).
+ */
+int searchLateMove(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack)
+{
+	int value;
+	if ((level % 2) == 1)
+	{	// Max turn parent
+		value = alphabetaReduced(context, state, level, alpha, alpha + 1, isABlack, LMR_REDUCTION);
+		if ((value <= alpha) || context->isStopped)
+			return value;
 	}
 	else
-	{	// Black turn
-		return (blackScore - whiteScore);
+	{	// Min turn parent
+		value = alphabetaReduced(context, state, level, beta - 1, beta, isABlack, LMR_REDUCTION);
+		if ((value >= beta) || context->isStopped)
+			return value;
 	}
+
+	return searchChild(context, state, level, alpha, beta, isABlack, false);
+}
+
+/*
+ * Null move pruning: returns true if the player to move is still beyond the bound of the board (beta for max
+ * turn, alpha for min turn) after passing the turn, searched NULL_MOVE_REDUCTION plies shallower. A real move is
+ * assumed to be at least as good as passing, so the board can be cut.
+ * Not tried in check (passing is illegal), without pieces (see hasPieces), after another null move, or when the
+ * bound is infinite.
+ */
+bool isNullMoveCutoff(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack)
+{
+	bool isMaxTurn = ((level % 2) == 0);
+	if ((isMaxTurn && (beta == INT_MAX)) || ((!isMaxTurn) && (alpha == INT_MIN)))
+		return false;
+	if ((context->ply > 0) && context->nullSteps[context->ply - 1])
+		return false;
+	if ((!hasPieces(state, isABlack)) || isCheck(state->board, isABlack))
+		return false;
+
+	int value;
+	makeNullMove(context, state);
+	if (isMaxTurn)
+		value = alphabetaReduced(context, state, level + 1, beta - 1, beta, !isABlack, NULL_MOVE_REDUCTION);
+	else
+		value = alphabetaReduced(context, state, level + 1, alpha, alpha + 1, !isABlack, NULL_MOVE_REDUCTION);
+	unmakeNullMove(context, state);
+
+	if (context->isStopped)
+		return false;
+
+	return isMaxTurn ? (value >= beta) : (value <= alpha);
 }
 
 /* 
  * Implement the Alphabeta pruning algorithm to decrease the number of nodes that are evaluated by the Minimax.
- * If there was an error set g_memError to true and return INT_MIN. 
+ * Moves are made and unmade through the undo stack of the search context, so the search does not allocate memory.
+ * Results of inner nodes are kept in the transposition table. A stored score cuts the search only if it was searched
+ * to exactly the same depth, so without null move pruning and late move reductions the result is the score of a
+ * minimax tree of the depth of the context, and the order of the moves only affects the number of boards visited.
+ * The leaves are extended with a quiescence search, unless it is off in the context.
+ * Null move pruning and late move reductions make the search selective: their results may differ from the full
+ * minimax tree's and depend on the order of the moves and the contents of the table, which keeps them.
+ * If the limits of the context stop the search, the result is invalid.
  */
-int alphabeta(char board[BOARD_SIZE][BOARD_SIZE], int level, int alpha, int beta, bool isABlack)
+int alphabeta(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack)
 {
-	LinkedList* moves = getMoves(board, isABlack);
-	if (g_memError)
-	{	// Error
-		return INT_MIN;
-	}
+	context->pvLengths[context->ply] = context->ply;	// No best line yet
+	if (isSearchStopped(context))
+		return 0;
 
-	// Check for mate or tie
-	if (isCheck(board, isABlack))
-	{	
-		if (moves->length == 0)
-		{	// Mate (leaf). Return score as for the parent level in the tree
-			deleteList(moves);
+	bool isMaxTurn = ((level % 2) == 0);
+	int depth = context->depth - level;	// Number of plies left below this node
+	CompactMove ttMove = NO_MOVE;
 
-			if ((level % 2) == 0)
-				return LOOSING_SCORE;	// Max turn
-			else
-				return WINNING_SCORE;	// Min turn
+	if ((depth == 0) && context->isQuiescence)
+		return quiescence(context, state, level, alpha, beta, isABlack);
+
+	// Check the transposition table. Its scores are kept for the player to move, while ours are for the root player.
+	TTEntry entry;
+	if ((depth > 0) && probeTranspositionTable(state->key, &entry, &(context->ttStats)))
+	{
+		ttMove = entry.bestMove;
+		if (entry.depth == depth)
+		{
+			int score = isMaxTurn ? entry.score : -entry.score;
+			TTBound bound = (TTBound)entry.bound;
+			if ((!isMaxTurn) && (bound != TT_BOUND_EXACT))
+				bound = (bound == TT_BOUND_LOWER) ? TT_BOUND_UPPER : TT_BOUND_LOWER;
+
+			if ((bound == TT_BOUND_EXACT) ||
+				((bound == TT_BOUND_LOWER) && (score >= beta)) ||
+				((bound == TT_BOUND_UPPER) && (score <= alpha)))
+			{
+				return score;
+			}
 		}
 	}
-	else if (moves->length == 0)
-	{	// Tie (leaf). Return worst score, except for loosing, for the parent.
-		deleteList(moves);
 
-		if ((level % 2) == 0)
-			return TIE_SCORE_ABS;	// Max turn
-		else
-			return -TIE_SCORE_ABS;	// Min turn
+	if (context->isNullMovePruning && (depth >= NULL_MOVE_MIN_DEPTH) &&
+		isNullMoveCutoff(context, state, level, alpha, beta, isABlack))
+	{
+		return isMaxTurn ? beta : alpha;	// Not the null move's score, which may be a false mate
 	}
 
-	// Check Minimax depth (leaf)
-	if (level == g_minimaxDepth)
+	// The moves are generated pseudo-legal, and each one is tested for legality only when it is played
+	MoveBuffer* moves = &(context->moves[context->ply]);
+	LegalityInfo legality;
+	generatePseudoLegalMoves(state, moves);
+	initLegalityInfo(state, &legality);
+
+	// Check Minimax depth (leaf). A leaf without legal moves is a mate or a tie
+	if (depth == 0)
 	{
-		deleteList(moves);
-		
+		if (!hasLegalMove(state, moves, &legality))
+			return getNoMovesScore(state->board, isABlack, isMaxTurn);
+
 		// Return score according to the color of the root of the minimax
-		if ((level % 2) == 0)
-			return getScore(board, isABlack);
+		if (isMaxTurn)
+			return context->evaluate(state, isABlack);
 		else
-			return getScore(board, !isABlack);
+			return context->evaluate(state, !isABlack);
 	}
 
+	// The best move of a previous search of this position is likely to cause an early cutoff, then captures of
+	// valuable pieces and the quiet moves that caused cutoffs elsewhere in the tree
+	if (context->isMoveOrdering)
+		orderMoves(state, moves, isABlack, ttMove, &(context->killers[context->ply]), &(context->history));
+	else if (ttMove != NO_MOVE)
+		moveToFront(moves, ttMove);
+
+	// Late quiet moves are reduced, unless the player is in check
+	bool isReducible = context->isLateMoveReduction && (depth >= LMR_MIN_DEPTH) && (!legality.isInCheck);
+
+	int originalAlpha = alpha;
+	int originalBeta = beta;
+	CompactMove bestMove = NO_MOVE;
 	int value, alphabetaResult;
-	if ((level % 2) == 0)
+	bool isQuiet, isReduced;
+	int numOfLegalMoves = 0;	// The legal moves played so far
+	int i;
+	if (isMaxTurn)
 	{	// Max turn
 		value = INT_MIN;
 		
-		Node* currMove = moves->head;
-		while ((currMove != NULL) && (beta > alpha))
+		for (i = 0; (i < moves->length) && (beta > alpha); i++)
 		{
-			Move* currMoveData = (Move*)(currMove->data);
-			GameStep* currGameStep = createGameStep(board, currMoveData);	// Convert Move to gameStep
-			if (g_memError)
-			{	// Error
-				deleteList(moves);
-				return INT_MIN;
-			}
-			doStep(board, currGameStep);
-			g_boardsCounter++;
+			if (!isLegalMove(state, moves->moves[i], &legality))
+				continue;
 
-			// Call alphabeta algorithm on the current move (child)
-			alphabetaResult = alphabeta(board, level + 1, alpha, beta, !isABlack);			
-			if (g_memError)
-			{
-				undoStep(board, currGameStep);
-				deleteGameStep(currGameStep);
-				deleteList(moves);
-				return INT_MIN;
-			}
+			isQuiet = isQuietMove(state, moves->moves[i]);
+			isReduced = isReducible && isQuiet && (numOfLegalMoves >= LMR_MIN_MOVE_INDEX) &&
+						(!isKillerMove(&(context->killers[context->ply]), moves->moves[i]));
+			makeMove(context, state, moves->moves[i]);
+
+			// Call alphabeta algorithm on the current move (child). Moves that give check are never reduced
+			if (isReduced && (!isCheck(state->board, !isABlack)))
+				alphabetaResult = searchLateMove(context, state, level + 1, alpha, beta, !isABlack);
+			else
+				alphabetaResult = searchChild(context, state, level + 1, alpha, beta, !isABlack,
+											  (numOfLegalMoves == 0));
+			unmakeMove(context, state);
+			numOfLegalMoves++;
 
 			// Max between value and alphabeta result 
 			if (value < alphabetaResult)
 			{
 				value = alphabetaResult;
+				bestMove = moves->moves[i];
 			}
 
-			// Max between alpha and value 
+			// Max between alpha and value. A move that raises alpha leads the best line
 			if (alpha < value)
 			{
 				alpha = value;
+				updatePrincipalVariation(context, moves->moves[i]);
 			}
 
-			undoStep(board, currGameStep);
-			deleteGameStep(currGameStep);
-			currMove = currMove->next;
+			if ((beta <= alpha) && isQuiet && context->isMoveOrdering)
+				addCutoffMove(context, isABlack, moves->moves[i], depth);
 		}
 	}
 	else
 	{	// Min turn
 		value = INT_MAX;
 
-		Node* currMove = moves->head;
-		while ((currMove != NULL) && (beta > alpha))
+		for (i = 0; (i < moves->length) && (beta > alpha); i++)
 		{
-			Move* currMoveData = (Move*)(currMove->data);
-			GameStep* currGameStep = createGameStep(board, currMoveData);	// Convert Move to gameStep
-			if (g_memError)
-			{	// Error
-				deleteList(moves);
-				return INT_MIN;
-			}
-			doStep(board, currGameStep);
-			g_boardsCounter++;
+			if (!isLegalMove(state, moves->moves[i], &legality))
+				continue;
 
-			// Call alphabeta algorithm on the current move (child)
-			alphabetaResult = alphabeta(board, level + 1, alpha, beta, !isABlack);
-			if (g_memError)
-			{
-				undoStep(board, currGameStep);
-				deleteGameStep(currGameStep);
-				deleteList(moves);
-				return INT_MIN;
-			}
+			isQuiet = isQuietMove(state, moves->moves[i]);
+			isReduced = isReducible && isQuiet && (numOfLegalMoves >= LMR_MIN_MOVE_INDEX) &&
+						(!isKillerMove(&(context->killers[context->ply]), moves->moves[i]));
+			makeMove(context, state, moves->moves[i]);
+
+			// Call alphabeta algorithm on the current move (child). Moves that give check are never reduced
+			if (isReduced && (!isCheck(state->board, !isABlack)))
+				alphabetaResult = searchLateMove(context, state, level + 1, alpha, beta, !isABlack);
+			else
+				alphabetaResult = searchChild(context, state, level + 1, alpha, beta, !isABlack,
+											  (numOfLegalMoves == 0));
+			unmakeMove(context, state);
+			numOfLegalMoves++;
 
 			// Min between value and alphabeta result 
 			if (value > alphabetaResult)
 			{
 				value = alphabetaResult;
+				bestMove = moves->moves[i];
 			}
 
-			// Min between beta and value
+			// Min between beta and value. A move that lowers beta leads the best line
 			if (beta > value)
 			{
 				beta = value;
+				updatePrincipalVariation(context, moves->moves[i]);
 			}
 
-			undoStep(board, currGameStep);
-			deleteGameStep(currGameStep);
-			currMove = currMove->next;
+			if ((beta <= alpha) && isQuiet && context->isMoveOrdering)
+				addCutoffMove(context, isABlack, moves->moves[i], depth);
 		}
 	}
 
-	deleteList(moves);
+	// Check for mate or tie
+	if (numOfLegalMoves == 0)
+		return getNoMovesScore(state->board, isABlack, isMaxTurn);
+
+	if (context->isStopped)
+		return 0;	// Partial result, must not be stored
+
+	// Store the result for the player to move: a bound of the root player turns over for the other player
+	TTBound bound = TT_BOUND_EXACT;
+	if (value <= originalAlpha)
+		bound = isMaxTurn ? TT_BOUND_UPPER : TT_BOUND_LOWER;
+	else if (value >= originalBeta)
+		bound = isMaxTurn ? TT_BOUND_LOWER : TT_BOUND_UPPER;
+	storeTranspositionTable(state->key, depth, bound, isMaxTurn ? value : -value, bestMove, &(context->ttStats));
+
 	return value;
 }
 
-/* 
- * Implement the Minimax algorithm.
- * If there was an error set g_memError to true and return NULL. 
+/*
+ * Search the board reached by a move, as the child at the given level, within the window (alpha, beta).
+ * In a principal variation search, a move after the first (isPvMove == false) is expected to be worse than the
+ * best move so far, so it is first searched with a null window that only tells whether it beats the bound of the
+ * parent (alpha for max turn, beta for min turn). Only a move that does is searched again with the full window.
  */
-Move* minimax(char board[BOARD_SIZE][BOARD_SIZE], bool isABlack)
+int searchChild(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack,
+				bool isPvMove)
 {
-	g_boardsCounter = 0;
-	LinkedList* moves = getMoves(board, isABlack);	// Get moves for current state
-	if (g_memError)
-	{	// Error
-		return NULL;
+	if (isPvMove || (!context->isPvs) || (alpha + 1 >= beta))
+		return alphabeta(context, state, level, alpha, beta, isABlack);
+
+	int value;
+	if ((level % 2) == 1)
+	{	// Max turn parent: does the move raise alpha?
+		value = alphabeta(context, state, level, alpha, alpha + 1, isABlack);
+		if ((value > alpha) && (value < beta) && (!context->isStopped))
+			value = alphabeta(context, state, level, alpha, beta, isABlack);
 	}
+	else
+	{	// Min turn parent: does the move lower beta?
+		value = alphabeta(context, state, level, beta - 1, beta, isABlack);
+		if ((value < beta) && (value > alpha) && (!context->isStopped))
+			value = alphabeta(context, state, level, alpha, beta, isABlack);
+	}
+
+	return value;
+}
 
-	Node* currMove = moves->head;
+/*
+ * Search all the moves of the root with the depth of the context, within the window (alpha, beta), on the calling
+ * thread. Returns the index of the best move in the buffer (the first one in case of equal scores) and sets
+ * bestValue to its value, or returns -1 if the search was stopped by its limits.
+ * If no move is better than alpha, bestValue is alpha and the index is meaningless (fail low). If bestValue is beta
+ * or more, it is only a lower bound and a later move might be better (fail high), unless it is WINNING_SCORE.
+ */
+int searchRootMovesSerial(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+						  int alpha, int beta, int* bestValue)
+{
+	int i;
 	int value;
-	int maxValue = INT_MIN;
-	Move* winMove = NULL;
-	while (currMove != NULL)
-	{
-		Move* currMoveData = (Move*)(currMove->data);
-		GameStep* currGameStep = createGameStep(board, currMoveData);	// Convert Move to gameStep
-		if (g_memError)
-		{	// Error
-			deleteList(moves);
-			return NULL;
-		}
-		doStep(board, currGameStep);
-		g_boardsCounter++;
+	int maxValue = alpha;
+	int winMoveIndex = 0;
+	context->pvLengths[0] = 0;
+	for (i = 0; (i < moves->length) && (maxValue < beta); i++)
+	{
+		makeMove(context, state, moves->moves[i]);
 	
-		// Call alphabeta algorithm on the current move (child)
-		value = alphabeta(board, 1, INT_MIN, INT_MAX, !isABlack);
-		if (g_memError)
-		{
-			undoStep(board, currGameStep);
-			deleteGameStep(currGameStep);
-			deleteList(moves);
-			return NULL;
-		}
+		// Call alphabeta algorithm on the current move (child). Without PVS every move gets the whole window
+		if (context->isPvs)
+			value = searchChild(context, state, 1, maxValue, beta, !isABlack, (i == 0));
+		else
+			value = alphabeta(context, state, 1, alpha, beta, !isABlack);
+		unmakeMove(context, state);
+		if (context->isStopped)
+			return -1;
 
 		// Check if we had a winning move
 		if (value == WINNING_SCORE)
 		{
-			undoStep(board, currGameStep);
-			deleteGameStep(currGameStep);
-			Move* returnedWinMove = cloneMove(currMoveData);
-			deleteList(moves);
-			return returnedWinMove;
+			updatePrincipalVariation(context, moves->moves[i]);
+			*bestValue = value;
+			return i;
 		}
 
 		// Check if the current value is greater than the previous ones (the root is max turn)
 		if (value > maxValue)
 		{
 			maxValue = value;
-			winMove = currMoveData;	// Save winning move
+			winMoveIndex = i;	// Save winning move
+			updatePrincipalVariation(context, moves->moves[i]);
+		}
+	}
+
+	*bestValue = maxValue;
+	return winMoveIndex;
+}
+
+/*
+ * Search all the moves of the root with the depth of the context, within the window (alpha, beta).
+ * In root split mode with more than one search thread the moves are split between the threads
+ * (see searchRootMovesParallel).
+ * Returns the index of the best move and sets its value as searchRootMovesSerial does,
+ * or returns -1 if the search was stopped by its limits.
+ */
+int searchRootMoves(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+					int alpha, int beta, int* bestValue)
+{
+	if ((getParallelMode() == PARALLEL_ROOT_SPLIT) && (getNumOfSearchThreads() > 1) && (moves->length > 1))
+		return searchRootMovesParallel(context, state, moves, isABlack, alpha, beta, bestValue);
+	else
+		return searchRootMovesSerial(context, state, moves, isABlack, alpha, beta, bestValue);
+}
+
+/*
+ * Multi-PV search of the root: search all the moves of the root with the depth of the context, on the calling thread,
+ * so the values of the numOfPvs best moves (1 to MAX_MULTI_PV) are exact, as are the values of the moves tied with
+ * them (if the search is exact, see setExactSearch). Every other move is only searched to tell it is worse, so its
+ * value is an upper bound below theirs.
+ * Sets values[i] to the value of move i and keeps the lines of the numOfPvs best moves in the lines of the context.
+ * Returns the index of the best move (the first one in case of equal scores), or -1 if the search was stopped by
+ * its limits.
+ */
+int searchRootMovesMultiPv(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+						   int numOfPvs, int values[])
+{
+	PvLine* lines = context->lines;	// The lines of the best moves so far, in descending order of values
+	int bestIndex = 0;
+	int alpha, value;
+	int i, j, k;
+	context->numOfLines = 0;
+	context->pvLengths[0] = 0;
+	for (i = 0; i < moves->length; i++)
+	{
+		// A move must reach the numOfPvs-th best value to be one of the best moves, so the window starts just below it
+		alpha = (context->numOfLines < numOfPvs) ? INT_MIN : (lines[numOfPvs - 1].value - 1);
+
+		makeMove(context, state, moves->moves[i]);
+		if (context->isPvs)
+			value = searchChild(context, state, 1, alpha, INT_MAX, !isABlack, (i < numOfPvs));
+		else
+			value = alphabeta(context, state, 1, alpha, INT_MAX, !isABlack);
+		unmakeMove(context, state);
+		if (context->isStopped)
+			return -1;
+
+		values[i] = value;
+		if ((i == 0) || (value > values[bestIndex]))
+		{
+			bestIndex = i;
+			updatePrincipalVariation(context, moves->moves[i]);
+		}
+
+		if ((value <= alpha) || ((context->numOfLines == numOfPvs) && (value == lines[numOfPvs - 1].value)))
+			continue;	// Not one of the best moves, or tied with the last one but found later
+
+		// Insert the line of the move into the best lines, dropping the last one if they are full
+		j = mini(context->numOfLines, numOfPvs - 1);
+		context->numOfLines = mini(context->numOfLines + 1, numOfPvs);
+		while ((j > 0) && (lines[j - 1].value < value))
+		{
+			lines[j] = lines[j - 1];
+			j--;
+		}
+		lines[j].value = value;
+		lines[j].moves[0] = moves->moves[i];
+		lines[j].length = maxi(context->pvLengths[1], 1);
+		for (k = 1; k < lines[j].length; k++)
+			lines[j].moves[k] = context->pvTable[1][k];
+	}
+
+	return bestIndex;
+}
+
+/*
+ * Search the root moves with an aspiration window around the score of the previous iteration, widening the window
+ * on the failing side until the best value is inside it. Returns as searchRootMoves, with the exact bestValue.
+ */
+int searchRootMovesAspiration(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+							  int previousValue, int* bestValue)
+{
+	// Mate and tie scores are far from the material scores, so they get no window
+	if (abs(previousValue) >= TIE_SCORE_ABS)
+		return searchRootMoves(context, state, moves, isABlack, INT_MIN, INT_MAX, bestValue);
+
+	int lowWindow = ASPIRATION_WINDOW;
+	int highWindow = ASPIRATION_WINDOW;
+	int alpha = previousValue - lowWindow;
+	int beta = previousValue + highWindow;
+	while (true)
+	{
+		int bestIndex = searchRootMoves(context, state, moves, isABlack, alpha, beta, bestValue);
+		if (bestIndex < 0)
+			return bestIndex;
+
+		if (*bestValue <= alpha)
+		{	// Fail low
+			lowWindow *= 4;
+			alpha = (lowWindow > ASPIRATION_MAX_WINDOW) ? INT_MIN : (previousValue - lowWindow);
+		}
+		else if ((*bestValue >= beta) && (*bestValue != WINNING_SCORE))
+		{	// Fail high
+			highWindow *= 4;
+			beta = (highWindow > ASPIRATION_MAX_WINDOW) ? INT_MAX : (previousValue + highWindow);
+		}
+		else
+		{
+			return bestIndex;
+		}
+	}
+}
+
+/* Returns true if the move is in the buffer. */
+bool isMoveInBuffer(const MoveBuffer* moves, CompactMove move)
+{
+	int i;
+	for (i = 0; i < moves->length; i++)
+	{
+		if (moves->moves[i] == move)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Transposition table cutoffs cut the principal variations short, so extend the line of the board with the best
+ * moves of the table (as long as they are legal) up to the given length.
+ */
+void extendPrincipalVariation(BoardState* state, CompactMove line[MAX_SEARCH_PLY], int* length, int maxLength)
+{
+	GameStep steps[MAX_SEARCH_PLY];
+	int i;
+	for (i = 0; i < *length; i++)
+	{
+		initGameStep(state->board, line[i], &(steps[i]));
+		doStep(state, &(steps[i]));
+	}
+
+	TTEntry entry;
+	TTStats stats;	// Not a part of the search statistics
+	MoveBuffer moves;
+	clearTranspositionTableStats(&stats);
+	while ((*length < maxLength) && probeTranspositionTable(state->key, &entry, &stats))
+	{
+		generateMoves(state, &moves);
+		if (!isMoveInBuffer(&moves, entry.bestMove))
+			break;
+
+		line[*length] = entry.bestMove;
+		initGameStep(state->board, entry.bestMove, &(steps[*length]));
+		doStep(state, &(steps[*length]));
+		(*length)++;
+	}
+
+	for (i = *length - 1; i >= 0; i--)
+		undoStep(state, &(steps[i]));
+}
+
+/*
+ * Keep the principal variation of the completed iteration of the given depth in the info of the context, and the
+ * lines of the best moves if it is a multi-PV search (numOfLines of the context is 0 otherwise).
+ */
+void setSearchInfo(SearchContext* context, BoardState* state, int depth, int value)
+{
+	SearchInfo* info = &(context->info);
+	info->depth = depth;
+	info->score = getPawnScore(value);
+	info->length = context->pvLengths[0];
+
+	int i;
+	for (i = 0; i < info->length; i++)
+		info->moves[i] = context->pvTable[0][i];
+	extendPrincipalVariation(state, info->moves, &(info->length), depth);
+
+	info->numOfLines = context->numOfLines;
+	for (i = 0; i < info->numOfLines; i++)
+	{
+		info->lines[i] = context->lines[i];
+		info->lines[i].value = getPawnScore(info->lines[i].value);
+		extendPrincipalVariation(state, info->lines[i].moves, &(info->lines[i].length), depth);
+	}
+}
+
+/*
+ * Iterative deepening: search the root moves with depth 1, 2, 3... up to maxDepth, or until the limits of the
+ * context stop the search. The first iteration always completes, so a move is always found.
+ * With aspiration windows, each iteration starts with a narrow window around the score of the previous one.
+ * The principal variation of the deepest completed iteration and the measures of the search are kept in the info of
+ * the context.
+ * In Lazy SMP mode with more than one search thread, helper threads search the same root meanwhile
+ * (see startLazySmpHelpers). Only this search decides the move, the helpers just fill the transposition table.
+ * Returns the depth of the deepest completed iteration and sets bestIndex to the best move it found.
+ */
+int iterativeDeepening(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+					   int maxDepth, int* bestIndex)
+{
+	long long startTime = getTimeInMs();
+	context->numOfLines = 0;	// A single best line
+	struct LazySmp* lazySmp = NULL;
+	if ((getParallelMode() == PARALLEL_LAZY_SMP) && (getNumOfSearchThreads() > 1))
+		lazySmp = startLazySmpHelpers(context, state, moves, isABlack, mini(maxDepth, MAX_SEARCH_PLY - 1));
+
+	// Keep the limits aside until the first iteration completes
+	long long endTime = context->endTime;
+	unsigned long long nodeLimit = context->nodeLimit;
+	context->endTime = 0;
+	context->nodeLimit = 0;
+
+	int depth;
+	int completedDepth = 0;
+	int value = 0;
+	int iterationBestIndex;
+	maxDepth = mini(maxDepth, MAX_SEARCH_PLY - 1);
+	for (depth = 1; depth <= maxDepth; depth++)
+	{
+		context->depth = depth;
+		if (context->isAspiration && (completedDepth > 0))
+			iterationBestIndex = searchRootMovesAspiration(context, state, moves, isABlack, value, &value);
+		else
+			iterationBestIndex = searchRootMoves(context, state, moves, isABlack, INT_MIN, INT_MAX, &value);
+		if (iterationBestIndex < 0)
+			break;	// Out of time or boards, the iteration is incomplete
+
+		*bestIndex = iterationBestIndex;
+		completedDepth = depth;
+		setSearchInfo(context, state, depth, value);
+
+		// The limits are not checked on every board, so check them once more before starting a deeper iteration
+		context->endTime = endTime;
+		context->nodeLimit = nodeLimit;
+		if ((nodeLimit > 0) && (context->nodes >= nodeLimit))
+			break;
+		if ((endTime > 0) && (getTimeInMs() >= endTime))
+			break;
+	}
+
+	if (lazySmp != NULL)
+		stopLazySmpHelpers(lazySmp, context);
+
+	context->info.nodes = context->nodes;
+	context->info.qnodes = context->qnodes;
+	context->info.timeInMs = getTimeInMs() - startTime;
+
+	return completedDepth;
+}
+
+/*
+ * Iterative deepening of a multi-PV search (see searchRootMovesMultiPv), with the limits of iterativeDeepening.
+ * The root moves are sorted by their values after every iteration, so the best moves are searched first.
+ * Sets values[i] to the value of moves->moves[i] in the deepest completed iteration and returns its depth.
+ */
+int iterativeDeepeningMultiPv(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+							  int maxDepth, int numOfPvs, int values[])
+{
+	long long startTime = getTimeInMs();
+
+	// The root moves in search order, and the index of each one in the given moves
+	MoveBuffer rootMoves = *moves;
+	int rootIndices[MAX_MOVES];
+	int rootValues[MAX_MOVES];
+	int i, j;
+	for (i = 0; i < rootMoves.length; i++)
+		rootIndices[i] = i;
+
+	// Keep the limits aside until the first iteration completes
+	long long endTime = context->endTime;
+	unsigned long long nodeLimit = context->nodeLimit;
+	context->endTime = 0;
+	context->nodeLimit = 0;
+
+	int depth;
+	int completedDepth = 0;
+	int bestIndex;
+	maxDepth = mini(maxDepth, MAX_SEARCH_PLY - 1);
+	for (depth = 1; depth <= maxDepth; depth++)
+	{
+		context->depth = depth;
+		bestIndex = searchRootMovesMultiPv(context, state, &rootMoves, isABlack, numOfPvs, rootValues);
+		if (bestIndex < 0)
+			break;	// Out of time or boards, the iteration is incomplete
+
+		completedDepth = depth;
+		setSearchInfo(context, state, depth, rootValues[bestIndex]);
+		for (i = 0; i < rootMoves.length; i++)
+			values[rootIndices[i]] = rootValues[i];
+
+		// Stable insertion sort by descending values, so moves of equal values keep their order
+		for (i = 1; i < rootMoves.length; i++)
+		{
+			CompactMove move = rootMoves.moves[i];
+			int index = rootIndices[i];
+			int value = rootValues[i];
+			for (j = i; (j > 0) && (rootValues[j - 1] < value); j--)
+			{
+				rootMoves.moves[j] = rootMoves.moves[j - 1];
+				rootIndices[j] = rootIndices[j - 1];
+				rootValues[j] = rootValues[j - 1];
+			}
+			rootMoves.moves[j] = move;
+			rootIndices[j] = index;
+			rootValues[j] = value;
 		}
 
-		undoStep(board, currGameStep);
-		deleteGameStep(currGameStep);
-		currMove = currMove->next;
+		// The limits are not checked on every board, so check them once more before starting a deeper iteration
+		context->endTime = endTime;
+		context->nodeLimit = nodeLimit;
+		if ((nodeLimit > 0) && (context->nodes >= nodeLimit))
+			break;
+		if ((endTime > 0) && (getTimeInMs() >= endTime))
+			break;
 	}
 
-	winMove = cloneMove(winMove);
+	context->info.nodes = context->nodes;
+	context->info.qnodes = context->qnodes;
+	context->info.timeInMs = getTimeInMs() - startTime;
+
+	return completedDepth;
+}
+
+/* Add the transposition table statistics of the search to the table's, and reset them for the next search. */
+void flushSearchStats(SearchContext* context)
+{
+	addTranspositionTableStats(&(context->ttStats));
+	clearTranspositionTableStats(&(context->ttStats));
+}
+
+/*
+ * Turn the features of the search the user may turn off on or off according to the user's settings
+ * (g_isQuiescence, g_isNullMovePruning, g_isLateMoveReduction), and set the evaluator the user chose.
+ */
+void applySearchSettings(SearchContext* context)
+{
+	context->isQuiescence = g_isQuiescence;
+	context->isNullMovePruning = g_isNullMovePruning;
+	context->isLateMoveReduction = g_isLateMoveReduction;
+	context->evaluate = g_evaluators[getEvaluatorType()].evaluate;
+}
+
+/*
+ * Turn off the selective features of the search (null move pruning and late move reductions) for a request of exact
+ * scores, which are then the scores of the full minimax tree whatever the threads and the earlier searches.
+ * Scores stored in the transposition table by a selective search are discarded.
+ */
+void setExactSearch(SearchContext* context)
+{
+	if (context->isNullMovePruning || context->isLateMoveReduction)
+		clearTranspositionTable();	// The stored scores may be of a selective search
+	context->isNullMovePruning = false;
+	context->isLateMoveReduction = false;
+}
+
+/*
+ * Prepare the context for a search request up to the given depth (clamped to 1..MAX_DEPTH), limited and with the
+ * features according to the user's settings (g_searchTimeLimit, g_searchNodeLimit, see applySearchSettings).
+ * Difficulty best is also bound by its own time budget, BEST_DIFFICULTY_TIME_LIMIT_MS.
+ */
+void initSearchRequest(SearchContext* context, int maxDepth, bool isDifficultyBest)
+{
+	initSearchContext(context, mini(maxi(maxDepth, 1), MAX_DEPTH));
+	applySearchSettings(context);
+
+	int timeLimitMs = g_searchTimeLimit;
+	if (isDifficultyBest)
+		timeLimitMs = (timeLimitMs > 0) ? mini(timeLimitMs, BEST_DIFFICULTY_TIME_LIMIT_MS) : BEST_DIFFICULTY_TIME_LIMIT_MS;
+
+	setSearchLimits(context, timeLimitMs, (unsigned long long)g_searchNodeLimit);
+}
+
+/*
+ * Returns the score of the move for the player, with iterative deepening of the move alone up to the maxDepth of the
+ * context: the score in a minimax tree of the deepest depth completed within the limits of the context. The search
+ * is exact (see setExactSearch).
+ * The first depth is always completed, whatever the limits.
+ * On an error, isError of the context is set to true and INT_MIN is returned.
+ */
+int getMoveScore(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isABlack, CompactMove move)
+{
+	if (!initTranspositionTable())
+	{
+		context->isError = true;
+		return INT_MIN;
+	}
+	setExactSearch(context);
+
+	BoardState state;
+	initBoardState(&state, board, isABlack);
+
+	// Keep the limits aside until the first iteration completes
+	long long endTime = context->endTime;
+	unsigned long long nodeLimit = context->nodeLimit;
+	context->endTime = 0;
+	context->nodeLimit = 0;
+	context->isStopped = false;
+
+	int depth, value;
+	int score = INT_MIN;
+	int maxDepth = mini(context->maxDepth, MAX_SEARCH_PLY - 1);
+	for (depth = 1; depth <= maxDepth; depth++)
+	{
+		// Call alphabeta algorithm with the depth of the iteration, on the requested move
+		context->ply = 0;
+		context->depth = depth;
+		makeMove(context, &state, move);
+		value = alphabeta(context, &state, 1, INT_MIN, INT_MAX, !isABlack);
+		unmakeMove(context, &state);
+		if (context->isStopped)
+			break;	// Out of time or boards, the iteration is incomplete
+
+		score = value;
+
+		// The limits are not checked on every board, so check them once more before starting a deeper iteration
+		context->endTime = endTime;
+		context->nodeLimit = nodeLimit;
+		if ((nodeLimit > 0) && (context->nodes >= nodeLimit))
+			break;
+		if ((endTime > 0) && (getTimeInMs() >= endTime))
+			break;
+	}
+
+	flushSearchStats(context);
+
+	return score;
+}
+
+/*
+ * Multi-PV search of the player's moves (see searchRootMovesMultiPv), with iterative deepening up to the maxDepth of
+ * the context as long as its limits allow it. The best moves of every iteration are searched first in the next one.
+ * Fills moves with the moves of the player, and values with their values in the deepest completed iteration (only the
+ * values of the numOfPvs best moves and the moves tied with them are exact). The lines of the numOfPvs best moves
+ * are kept in the info of the context. The search is exact (see setExactSearch).
+ * Returns the depth of that iteration, or 0 if the player has no moves or there was an error (isError of the context
+ * is set to true).
+ */
+int searchMultiPv(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isABlack, int numOfPvs,
+				  MoveBuffer* moves, int values[])
+{
+	moves->length = 0;
+	context->info.numOfLines = 0;
+	numOfPvs = maxi(1, mini(numOfPvs, MAX_MULTI_PV));
+	if (!initTranspositionTable())
+	{
+		context->isError = true;
+		return 0;
+	}
+	setExactSearch(context);
+
+	BoardState state;
+	initBoardState(&state, board, isABlack);
+
+	generateMoves(&state, moves);
+	if (moves->length == 0)
+		return 0;
+
+	int depth = iterativeDeepeningMultiPv(context, &state, moves, isABlack, context->maxDepth, numOfPvs, values);
+	flushSearchStats(context);
+
+	return depth;
+}
+
+/*
+ * Implement the Minimax algorithm.
+ * The depth grows by iterative deepening up to the maxDepth of the context, as long as its limits allow it.
+ * Returns the chosen move, or NO_MOVE if the player has no moves or there was an error (isError of the context
+ * is set to true).
+ */
+CompactMove minimax(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isABlack)
+{
+	if (!initTranspositionTable())
+	{
+		context->isError = true;
+		return NO_MOVE;
+	}
+
+	BoardState state;
+	initBoardState(&state, board, isABlack);
+
+	MoveBuffer moves;
+	generateMoves(&state, &moves);	// Get moves for current state
+	if (moves.length == 0)
+		return NO_MOVE;
+
+	int winMoveIndex = 0;
+	iterativeDeepening(context, &state, &moves, isABlack, context->maxDepth, &winMoveIndex);
+	flushSearchStats(context);
 
-	deleteList(moves);
-	return winMove;
+	return moves.moves[winMoveIndex];
 }
\ No newline at end of file
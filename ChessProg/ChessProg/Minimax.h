@@ -2,21 +2,263 @@
 #define MINIMAX_
 
 #include "Types.h"
+#include "BitBoard.h"
+#include "BoardManager.h"
+#include "MoveOrdering.h"
+#include "TranspositionTable.h"
+#include "Evaluation.h"
 
-#define PAWN_SCORE 1
-#define BISHOP_SCORE 3
-#define ROOK_SCORE 5
-#define KNIGHT_SCORE 3
-#define QUEEN_SCORE 9
-#define KING_SCORE 400
-#define WINNING_SCORE 1000
-#define LOOSING_SCORE -1000
-#define TIE_SCORE_ABS 200
+/* The scores of the search are in hundredths of a pawn (see PAWN_SCORE), the scores shown to the user in pawns. */
+#define WINNING_SCORE (1000 * PAWN_SCORE)
+#define LOOSING_SCORE (-1000 * PAWN_SCORE)
+#define TIE_SCORE_ABS (200 * PAWN_SCORE)
 
-int getScore(char board[BOARD_SIZE][BOARD_SIZE], bool isABlack);
+/* Maximum number of plies a single search may go down the tree (size of the undo stack). */
+#define MAX_SEARCH_PLY 64
 
-int alphabeta(char board[BOARD_SIZE][BOARD_SIZE], int level, int alpha, int beta, bool isABlack);
+/* Time budget of a computer move in difficulty best, which searches as deep as the time allows. */
+#define BEST_DIFFICULTY_TIME_LIMIT_MS 2000
 
-Move* minimax(char board[BOARD_SIZE][BOARD_SIZE], bool isABlack);
+/* Number of boards between two checks of the search time limit. Must be a power of two. */
+#define TIME_CHECK_INTERVAL 1024
+
+/*
+ * Delta pruning margin of the quiescence search: a capture is skipped when even winning the captured piece and
+ * this many more pawns can't bring the score back into the window.
+ */
+#define QUIESCENCE_DELTA_MARGIN (2 * PAWN_SCORE)
+
+/*
+ * Aspiration windows: an iteration is first searched with a window of this many pawns around the score of the
+ * previous one. A search that fails outside the window is repeated with a window 4 times wider on the failing side,
+ * and once it is wider than ASPIRATION_MAX_WINDOW, with no bound on that side.
+ */
+#define ASPIRATION_WINDOW (2 * PAWN_SCORE)
+#define ASPIRATION_MAX_WINDOW (32 * PAWN_SCORE)
+
+/*
+ * Null move pruning: a board with at least this many plies left is first searched after passing the turn, this
+ * many plies shallower. If the opponent is still lost, moving would only make it worse for the opponent.
+ */
+#define NULL_MOVE_MIN_DEPTH 3
+#define NULL_MOVE_REDUCTION 2
+
+/*
+ * Late move reductions: in a board with at least this many plies left, quiet moves from this index on are first
+ * searched this many plies shallower.
+ */
+#define LMR_MIN_DEPTH 3
+#define LMR_MIN_MOVE_INDEX 3
+#define LMR_REDUCTION 1
+
+/* The state shared by the threads of a Lazy SMP search (see ParallelSearch.h). */
+struct LazySmp;
+
+/* A line of a multi-PV search: a root move, its value and the principal variation that starts with it. */
+typedef struct
+{
+	int value;							// The value of the root move, for the root player
+	CompactMove moves[MAX_SEARCH_PLY];	// The principal variation, starting with the root move
+	int length;							// Number of moves in the principal variation
+} PvLine;
+
+/*
+ * What a search request found and what it took, for diagnosing its move: the principal variation (the line both
+ * players are expected to play) of the deepest completed iteration, and the boards and time of the whole request.
+ */
+typedef struct
+{
+	CompactMove moves[MAX_SEARCH_PLY];	// The principal variation, starting with the chosen move
+	int length;						// Number of moves in the principal variation
+	int score;						// The score of the chosen move in pawns, for the root player
+	int depth;						// The depth of the deepest completed iteration. 0 if nothing was searched
+	PvLine lines[MAX_MULTI_PV];		// The lines of the best moves of a multi-PV search (values in pawns), best first
+	int numOfLines;					// Number of lines, 0 if the request was not a multi-PV search
+	unsigned long long nodes;		// Number of boards visited by the request
+	unsigned long long qnodes;		// Number of these boards visited by the quiescence search
+	long long timeInMs;				// Duration of the request
+} SearchInfo;
+
+/*
+ * The state of a single search request, passed explicitly through the search.
+ * Moves done by the search keep their undo information in a preallocated stack, one game step per ply, and the
+ * moves of every ply are generated into a preallocated buffer, so the search never allocates memory.
+ * The search reads and writes only its context (and the transposition table), so several searches may run at once.
+ */
+typedef struct
+{
+	GameStep steps[MAX_SEARCH_PLY];	// The undo stack. steps[i] is the step done to reach ply i + 1
+	bool nullSteps[MAX_SEARCH_PLY];	// nullSteps[i] is true if ply i + 1 was reached by a null move
+	CompactMove pvTable[MAX_SEARCH_PLY][MAX_SEARCH_PLY];	// Triangular table, pvTable[i] is the best line from ply i
+	int pvLengths[MAX_SEARCH_PLY];	// The best line from ply i is pvTable[i][i] to pvTable[i][pvLengths[i] - 1]
+	PvLine lines[MAX_MULTI_PV];		// The lines of the best moves of the current multi-PV search, best first
+	int numOfLines;					// Number of lines
+	MoveBuffer moves[MAX_SEARCH_PLY];	// Scratch buffers. moves[i] holds the moves of the board at ply i
+	int ply;						// Number of steps currently done on the board by the search
+	int depth;						// Depth of the minimax tree (the level of its leaves)
+	int maxDepth;					// The deepest iteration of the request (see iterativeDeepening)
+	unsigned long long nodes;		// Number of boards visited by the search
+	unsigned long long qnodes;		// Number of these boards visited by the quiescence search
+	unsigned long long nodeLimit;	// The search stops after visiting this many boards. 0 for no limit
+	long long endTime;				// The search stops at this time (see getTimeInMs). 0 for no limit
+	bool isStopped;					// True once a limit was reached. The result of a stopped search is invalid
+	bool isMoveOrdering;			// True to order the moves before searching them, false for generation order
+	bool isQuiescence;				// True to extend the leaves with a quiescence search, false to score them as is
+	bool isPvs;						// True for a principal variation search, false to search every move fully
+	bool isAspiration;				// True to search the iterations with aspiration windows, false for full windows
+	bool isNullMovePruning;			// True to prune boards where passing the turn is already good enough
+	bool isLateMoveReduction;		// True to search late quiet moves with a reduced depth first
+	EvaluateFunction evaluate;		// Scores the leaves of the search (see Evaluation.h)
+	KillerMoves killers[MAX_SEARCH_PLY];	// killers[i] are the killer moves of the boards at ply i
+	HistoryTable history;			// History heuristic scores of the quiet moves
+	TTStats ttStats;				// Transposition table usage of the search
+	struct LazySmp* lazySmp;		// The Lazy SMP search this search helps, which may stop it. NULL if none
+	bool isError;					// True if the request failed (the transposition table couldn't be allocated)
+	SearchInfo info;				// The result of the request, set by iterativeDeepening
+} SearchContext;
+
+/* Returns the score of the search in pawns, rounded to the nearest pawn (the unit of the scores shown to the user). */
+int getPawnScore(int score);
+
+/* Reset the search context before a new search of the given depth, with no limits and all the search features. */
+void initSearchContext(SearchContext* context, int depth);
+
+/* Limit the search to the given time (from now) and number of boards. 0 means no limit. */
+void setSearchLimits(SearchContext* context, int timeLimitMs, unsigned long long nodeLimit);
+
+/* Execute the move on the board state and push its undo information to the undo stack of the search context. */
+void makeMove(SearchContext* context, BoardState* state, CompactMove move);
+
+/* Undo the last move done with makeMove and pop it from the undo stack of the search context. */
+void unmakeMove(SearchContext* context, BoardState* state);
+
+/* Pass the turn on the board state (see doNullStep) as a move of the search. */
+void makeNullMove(SearchContext* context, BoardState* state);
+
+/* Undo the null move done with makeNullMove. */
+void unmakeNullMove(SearchContext* context, BoardState* state);
+
+/* Remember a quiet move that caused a cutoff with the given number of plies left, for ordering the next searches. */
+void addCutoffMove(SearchContext* context, bool isABlack, CompactMove move, int depth);
+
+/* Make the move, followed by the best line of the next ply, the best line of the current ply of the search. */
+void updatePrincipalVariation(SearchContext* context, CompactMove move);
+
+/*
+ * The quiescence search at the leaves of the minimax tree: only captures and promotions are searched, until the
+ * board is quiet, so a leaf is never scored in the middle of an exchange.
+ */
+int quiescence(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack);
+
+/*
+ * The Alphabeta pruning of the Minimax tree of the depth of the context, with the transposition table.
+ * Without null move pruning and late move reductions the result is the score of the minimax tree. With them the
+ * search is selective, and its result depends on the order of the moves and the contents of the table.
+ * If the limits of the context stop the search, the result is invalid.
+ */
+int alphabeta(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack);
+
+/*
+ * Search the board reached by a move, as the child at the given level, within the window (alpha, beta).
+ * In a principal variation search, a move after the first (isPvMove == false) is expected to be worse than the
+ * best move so far, so it is first searched with a null window that only tells whether it beats the bound of the
+ * parent (alpha for max turn, beta for min turn). Only a move that does is searched again with the full window.
+ */
+int searchChild(SearchContext* context, BoardState* state, int level, int alpha, int beta, bool isABlack,
+				bool isPvMove);
+
+/*
+ * Search all the moves of the root with the depth of the context, within the window (alpha, beta), on the calling
+ * thread. Returns the index of the best move in the buffer (the first one in case of equal scores) and sets
+ * bestValue to its value, or returns -1 if the search was stopped by its limits.
+ * If no move is better than alpha, bestValue is alpha and the index is meaningless (fail low). If bestValue is beta
+ * or more, it is only a lower bound and a later move might be better (fail high), unless it is WINNING_SCORE.
+ */
+int searchRootMovesSerial(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+						  int alpha, int beta, int* bestValue);
+
+/*
+ * Search all the moves of the root with the depth of the context, within the window (alpha, beta).
+ * In root split mode with more than one search thread the moves are split between the threads
+ * (see searchRootMovesParallel).
+ * Returns the index of the best move and sets its value as searchRootMovesSerial does,
+ * or returns -1 if the search was stopped by its limits.
+ */
+int searchRootMoves(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+					int alpha, int beta, int* bestValue);
+
+/*
+ * Multi-PV search of the root: search all the moves of the root with the depth of the context, on the calling thread,
+ * so the values of the numOfPvs best moves (1 to MAX_MULTI_PV) are exact, as are the values of the moves tied with
+ * them (if the search is exact, see setExactSearch). Every other move is only searched to tell it is worse, so its
+ * value is an upper bound below theirs.
+ * Sets values[i] to the value of move i and keeps the lines of the numOfPvs best moves in the lines of the context.
+ * Returns the index of the best move (the first one in case of equal scores), or -1 if the search was stopped by
+ * its limits.
+ */
+int searchRootMovesMultiPv(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+						   int numOfPvs, int values[]);
+
+/*
+ * Iterative deepening: search the root moves with depth 1, 2, 3... up to maxDepth, or until the limits of the
+ * context stop the search. The first iteration always completes, so a move is always found.
+ * With aspiration windows, each iteration starts with a narrow window around the score of the previous one.
+ * The principal variation of the deepest completed iteration and the measures of the search are kept in the info of
+ * the context.
+ * In Lazy SMP mode with more than one search thread, helper threads search the same root meanwhile
+ * (see startLazySmpHelpers). Only this search decides the move, the helpers just fill the transposition table.
+ * Returns the depth of the deepest completed iteration and sets bestIndex to the best move it found.
+ */
+int iterativeDeepening(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+					   int maxDepth, int* bestIndex);
+
+/*
+ * Turn the features of the search the user may turn off on or off according to the user's settings
+ * (g_isQuiescence, g_isNullMovePruning, g_isLateMoveReduction), and set the evaluator the user chose.
+ */
+void applySearchSettings(SearchContext* context);
+
+/*
+ * Turn off the selective features of the search (null move pruning and late move reductions) for a request of exact
+ * scores, which are then the scores of the full minimax tree whatever the threads and the earlier searches.
+ * Scores stored in the transposition table by a selective search are discarded.
+ */
+void setExactSearch(SearchContext* context);
+
+/*
+ * Prepare the context for a search request up to the given depth (clamped to 1..MAX_DEPTH), limited and with the
+ * features according to the user's settings (g_searchTimeLimit, g_searchNodeLimit, see applySearchSettings).
+ * Difficulty best is also bound by its own time budget, BEST_DIFFICULTY_TIME_LIMIT_MS.
+ */
+void initSearchRequest(SearchContext* context, int maxDepth, bool isDifficultyBest);
+
+/*
+ * Returns the score of the move for the player, with iterative deepening of the move alone up to the maxDepth of the
+ * context: the score in a minimax tree of the deepest depth completed within the limits of the context. The search
+ * is exact (see setExactSearch).
+ * The first depth is always completed, whatever the limits.
+ * On an error, isError of the context is set to true and INT_MIN is returned.
+ */
+int getMoveScore(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isABlack, CompactMove move);
+
+/*
+ * Multi-PV search of the player's moves (see searchRootMovesMultiPv), with iterative deepening up to the maxDepth of
+ * the context as long as its limits allow it. The best moves of every iteration are searched first in the next one.
+ * Fills moves with the moves of the player, and values with their values in the deepest completed iteration (only the
+ * values of the numOfPvs best moves and the moves tied with them are exact). The lines of the numOfPvs best moves
+ * are kept in the info of the context. The search is exact (see setExactSearch).
+ * Returns the depth of that iteration, or 0 if the player has no moves or there was an error (isError of the context
+ * is set to true).
+ */
+int searchMultiPv(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isABlack, int numOfPvs,
+				  MoveBuffer* moves, int values[]);
+
+/*
+ * Implement the Minimax algorithm.
+ * The depth grows by iterative deepening up to the maxDepth of the context, as long as its limits allow it.
+ * Returns the chosen move, or NO_MOVE if the player has no moves or there was an error (isError of the context
+ * is set to true).
+ */
+CompactMove minimax(SearchContext* context, char board[BOARD_SIZE][BOARD_SIZE], bool isABlack);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <string.h>
+#include "MoveOrdering.h"
+
+/* Clear the killer moves of a ply. */
+void clearKillerMoves(KillerMoves* killers)
+{
+	int i;
+	for (i = 0; i < NUM_OF_KILLER_MOVES; i++)
+		killers->moves[i] = NO_MOVE;
+}
+
+/* Clear all the scores of the history table. */
+void clearHistoryTable(HistoryTable* history)
+{
+	memset(history->scores, 0, sizeof(history->scores));
+}
+
+/*
+ * Returns the type of the piece the move captures, or NO_PIECE_TYPE if it captures none. A pawn moving diagonally
+ * onto the en passant square captures the pawn beside it, though the square it moves to is vacant.
+ */
+PieceType getCapturedType(BoardState* state, CompactMove move)
+{
+	int start = MOVE_START_SQUARE(move);
+	int target = MOVE_TARGET_SQUARE(move);
+	PieceType victim = getPieceType(state->board[SQUARE_ROW(target)][SQUARE_COLUMN(target)]);
+	if ((victim == NO_PIECE_TYPE) && (target == state->enPassantSquare) &&
+		(SQUARE_COLUMN(target) != SQUARE_COLUMN(start)) &&
+		(getPieceType(state->board[SQUARE_ROW(start)][SQUARE_COLUMN(start)]) == PAWN_TYPE))
+		return PAWN_TYPE;
+
+	return victim;
+}
+
+/* Returns true if the move neither captures (en passant included) nor promotes. */
+bool isQuietMove(BoardState* state, CompactMove move)
+{
+	return ((getCapturedType(state, move) == NO_PIECE_TYPE) && (MOVE_PROMOTION_TYPE(move) == NO_PROMOTION_TYPE));
+}
+
+/*
+ * Returns the MVV-LVA (most valuable victim - least valuable attacker) score of a capture or promotion:
+ * the more valuable the captured piece and the cheaper the capturing piece, the higher the score.
+ */
+int getCaptureOrderScore(BoardState* state, CompactMove move)
+{
+	int start = MOVE_START_SQUARE(move);
+	PieceType attacker = getPieceType(state->board[SQUARE_ROW(start)][SQUARE_COLUMN(start)]);
+	PieceType victim = getCapturedType(state, move);
+
+	// PieceType values grow with the value of the piece, so they serve as ranks
+	int score = CAPTURE_ORDER;
+	if (victim != NO_PIECE_TYPE)
+		score += ((victim + 1) * NUM_OF_PIECE_TYPES * 2) - attacker;
+	if (MOVE_PROMOTION_TYPE(move) != NO_PROMOTION_TYPE)
+		score += MOVE_PROMOTION_TYPE(move) * NUM_OF_PIECE_TYPES;	// A queen promotion comes before a knight's
+
+	return score;
+}
+
+/* Returns the order score of a single move. See orderMoves. */
+int getMoveOrderScore(BoardState* state, CompactMove move, bool isBlackPlayer, CompactMove ttMove,
+					  const KillerMoves* killers, const HistoryTable* history)
+{
+	if (move == ttMove)
+		return TT_MOVE_ORDER;
+
+	if (!isQuietMove(state, move))
+		return getCaptureOrderScore(state, move);
+
+	if (killers != NULL)
+	{
+		int i;
+		for (i = 0; i < NUM_OF_KILLER_MOVES; i++)
+		{
+			if (killers->moves[i] == move)
+				return KILLER_MOVE_ORDER - i;
+		}
+	}
+
+	if (history != NULL)
+		return history->scores[isBlackPlayer][MOVE_START_SQUARE(move)][MOVE_TARGET_SQUARE(move)];
+
+	return 0;
+}
+
+/*
+ * Sort the moves so the most promising ones are searched first: the transposition table move,
+ * then captures and promotions by MVV-LVA, then killer moves, then quiet moves by their history score.
+ * The sort is stable, so moves of equal scores keep the order of the generation.
+ * killers and history may be NULL.
+ */
+void orderMoves(BoardState* state, MoveBuffer* moves, bool isBlackPlayer, CompactMove ttMove,
+				const KillerMoves* killers, const HistoryTable* history)
+{
+	int scores[MAX_MOVES];
+	int i, j;
+	for (i = 0; i < moves->length; i++)
+		scores[i] = getMoveOrderScore(state, moves->moves[i], isBlackPlayer, ttMove, killers, history);
+
+	// Insertion sort by descending score. Buffers are short, and mostly sorted after the first few moves
+	for (i = 1; i < moves->length; i++)
+	{
+		CompactMove move = moves->moves[i];
+		int score = scores[i];
+		for (j = i; (j > 0) && (scores[j - 1] < score); j--)
+		{
+			moves->moves[j] = moves->moves[j - 1];
+			scores[j] = scores[j - 1];
+		}
+
+		moves->moves[j] = move;
+		scores[j] = score;
+	}
+}
+
+/* Returns true if the move is one of the killer moves of the ply. */
+bool isKillerMove(const KillerMoves* killers, CompactMove move)
+{
+	int i;
+	for (i = 0; i < NUM_OF_KILLER_MOVES; i++)
+	{
+		if (killers->moves[i] == move)
+			return true;
+	}
+
+	return false;
+}
+
+/* Record a quiet move that caused a cutoff as the first killer move of its ply. */
+void addKillerMove(KillerMoves* killers, CompactMove move)
+{
+	if (killers->moves[0] == move)
+		return;
+
+	int i;
+	for (i = NUM_OF_KILLER_MOVES - 1; i > 0; i--)
+		killers->moves[i] = killers->moves[i - 1];
+
+	killers->moves[0] = move;
+}
+
+/* Reward a quiet move that caused a cutoff with the given number of plies left below it. */
+void addHistoryMove(HistoryTable* history, bool isBlackPlayer, CompactMove move, int depth)
+{
+	int* score = &(history->scores[isBlackPlayer][MOVE_START_SQUARE(move)][MOVE_TARGET_SQUARE(move)]);
+	*score += depth * depth;	// Cutoffs high in the tree save more boards
+
+	if (*score >= MAX_HISTORY_ORDER)
+	{	// Age all the scores of the player, so history stays below the killer moves and keeps up with the game
+		int i, j;
+		for (i = 0; i < NUM_OF_SQUARES; i++)
+		{
+			for (j = 0; j < NUM_OF_SQUARES; j++)
+				history->scores[isBlackPlayer][i][j] /= 2;
+		}
+	}
+}
\ No newline at end of file
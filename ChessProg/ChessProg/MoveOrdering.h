@@ -0,0 +1,70 @@
+#ifndef MOVE_ORDERING_
+#define MOVE_ORDERING_
+
+#include "Types.h"
+#include "BitBoard.h"
+#include "BoardManager.h"
+
+#define NUM_OF_KILLER_MOVES 2		// Killer moves kept for every ply of the search
+
+/* Order scores of the move kinds. A higher score is searched first. */
+#define TT_MOVE_ORDER 30000			// The best move stored in the transposition table
+#define CAPTURE_ORDER 20000			// Captures and promotions, ordered by MVV-LVA above this score
+#define KILLER_MOVE_ORDER 10000		// Killer moves, the first slot before the second one
+#define MAX_HISTORY_ORDER 9000		// Quiet moves are ordered by their history score, up to this score
+
+/* The quiet moves that caused a beta cutoff in a ply, most recent first. */
+typedef struct
+{
+	CompactMove moves[NUM_OF_KILLER_MOVES];
+} KillerMoves;
+
+/*
+ * The history heuristic: for every player and every (start square, target square) pair,
+ * a score that grows whenever a quiet move with these squares causes a cutoff.
+ */
+typedef struct
+{
+	int scores[NUM_OF_PLAYERS][NUM_OF_SQUARES][NUM_OF_SQUARES];
+} HistoryTable;
+
+/* Clear the killer moves of a ply. */
+void clearKillerMoves(KillerMoves* killers);
+
+/* Clear all the scores of the history table. */
+void clearHistoryTable(HistoryTable* history);
+
+/*
+ * Returns the type of the piece the move captures, or NO_PIECE_TYPE if it captures none. A pawn moving diagonally
+ * onto the en passant square captures the pawn beside it, though the square it moves to is vacant.
+ */
+PieceType getCapturedType(BoardState* state, CompactMove move);
+
+/* Returns true if the move neither captures (en passant included) nor promotes. */
+bool isQuietMove(BoardState* state, CompactMove move);
+
+/*
+ * Returns the MVV-LVA (most valuable victim - least valuable attacker) score of a capture or promotion:
+ * the more valuable the captured piece and the cheaper the capturing piece, the higher the score.
+ */
+int getCaptureOrderScore(BoardState* state, CompactMove move);
+
+/*
+ * Sort the moves so the most promising ones are searched first: the transposition table move,
+ * then captures and promotions by MVV-LVA, then killer moves, then quiet moves by their history score.
+ * The sort is stable, so moves of equal scores keep the order of the generation.
+ * killers and history may be NULL.
+ */
+void orderMoves(BoardState* state, MoveBuffer* moves, bool isBlackPlayer, CompactMove ttMove,
+				const KillerMoves* killers, const HistoryTable* history);
+
+/* Returns true if the move is one of the killer moves of the ply. */
+bool isKillerMove(const KillerMoves* killers, CompactMove move);
+
+/* Record a quiet move that caused a cutoff as the first killer move of its ply. */
+void addKillerMove(KillerMoves* killers, CompactMove move);
+
+/* Reward a quiet move that caused a cutoff with the given number of plies left below it. */
+void addHistoryMove(HistoryTable* history, bool isBlackPlayer, CompactMove move, int depth);
+
+#endif
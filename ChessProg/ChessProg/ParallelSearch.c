@@ -0,0 +1,304 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "ParallelSearch.h"
+#include "TranspositionTable.h"
+
+int g_numOfSearchThreads = 1;							// Configured number of threads
+ParallelMode g_parallelMode = PARALLEL_ROOT_SPLIT;		// Configured use of the threads
+
+/* Set the number of search threads. 1 searches on the calling thread only. */
+void setNumOfSearchThreads(int numOfThreads)
+{
+	g_numOfSearchThreads = numOfThreads;
+}
+
+/* Returns the number of search threads. */
+int getNumOfSearchThreads()
+{
+	return g_numOfSearchThreads;
+}
+
+/* Set how the search threads share the work. */
+void setParallelMode(ParallelMode mode)
+{
+	g_parallelMode = mode;
+}
+
+/* Returns how the search threads share the work. */
+ParallelMode getParallelMode()
+{
+	return g_parallelMode;
+}
+
+/*
+ * The body of a search thread: take the next root move, search it and publish its value, until no moves are left
+ * or a move failed high. Each move is searched with a window just below the best value found so far, so a move as
+ * good as the best is scored exactly (the first of them is chosen, as in the serial search) while worse moves are
+ * cut early.
+ */
+int searchRootMovesWorker(void* data)
+{
+	RootSplit* split = (RootSplit*)data;
+
+	// A private copy of the search, keeping the killer moves and history of the previous iterations
+	SearchContext context = *(split->context);
+	context.ply = 0;
+	context.nodes = 0;
+	context.qnodes = 0;
+	context.nodeLimit = split->nodeLimit;
+	context.isStopped = false;
+	clearTranspositionTableStats(&(context.ttStats));
+	BoardState state = *(split->rootState);
+
+	int i;
+	while (true)
+	{
+		SDL_mutexP(split->lock);
+		bool isDone = (split->isStopped || (split->nextMoveIndex >= split->moves->length) ||
+					   (split->bestValue >= split->beta));
+		int moveIndex = split->nextMoveIndex++;
+		bool isPvMove = (split->bestValue == split->alpha);	// No move beat alpha yet
+		int alpha = isPvMove ? split->alpha : (split->bestValue - 1);
+		SDL_mutexV(split->lock);
+		if (isDone)
+			break;
+
+		makeMove(&context, &state, split->moves->moves[moveIndex]);
+		int value = searchChild(&context, &state, 1, alpha, split->beta, !split->isABlack, isPvMove);
+		unmakeMove(&context, &state);
+
+		SDL_mutexP(split->lock);
+		if (context.isStopped)
+		{
+			split->isStopped = true;
+		}
+		else
+		{
+			split->values[moveIndex] = value;
+			if ((value > split->alpha) &&
+				((value > split->bestValue) || ((value == split->bestValue) && (moveIndex < split->pvMoveIndex))))
+			{	// The best line so far: this move followed by the best line of the board it reaches
+				split->pv[0] = split->moves->moves[moveIndex];
+				split->pvLength = maxi(context.pvLengths[1], 1);
+				for (i = 1; i < split->pvLength; i++)
+					split->pv[i] = context.pvTable[1][i];
+				split->pvMoveIndex = moveIndex;
+			}
+			if (value > split->bestValue)
+				split->bestValue = value;
+		}
+		SDL_mutexV(split->lock);
+	}
+
+	SDL_mutexP(split->lock);
+	split->nodes += context.nodes;
+	split->qnodes += context.qnodes;
+	sumTranspositionTableStats(&(split->ttStats), &(context.ttStats));
+	SDL_mutexV(split->lock);
+
+	return 0;
+}
+
+/*
+ * Search the root moves with the depth and limits of the context, within the window (alpha, beta), on several
+ * threads, each with its own board. Without null move pruning and late move reductions, returns the same move and
+ * value as a serial search (see searchRootMovesSerial): the index of the first move with the best value, or -1 if the
+ * search was stopped by its limits. A selective search depends on the order the threads fill the table in.
+ * The boards of all the threads are added to the context, and the principal variation to its PV table.
+ * If the threads can't be created, the moves are searched on the calling thread.
+ */
+int searchRootMovesParallel(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+							int alpha, int beta, int* bestValue)
+{
+	RootSplit split;
+	split.context = context;
+	split.rootState = state;
+	split.moves = moves;
+	split.isABlack = isABlack;
+	split.alpha = alpha;
+	split.beta = beta;
+	split.nodeLimit = 0;
+	split.nextMoveIndex = 0;
+	split.bestValue = alpha;
+	split.pvLength = 0;
+	split.pvMoveIndex = moves->length;
+	split.nodes = 0;
+	split.qnodes = 0;
+	clearTranspositionTableStats(&(split.ttStats));
+	split.isStopped = false;
+	split.lock = SDL_CreateMutex();
+	if (split.lock == NULL)
+		return searchRootMovesSerial(context, state, moves, isABlack, alpha, beta, bestValue);
+
+	// No point in more threads than moves. The node limit is split between the threads
+	int numOfThreads = mini(g_numOfSearchThreads, moves->length);
+	if (context->nodeLimit > 0)
+	{
+		unsigned long long nodesLeft = (context->nodes < context->nodeLimit) ? (context->nodeLimit - context->nodes) : 0;
+		split.nodeLimit = (nodesLeft / numOfThreads) + 1;
+	}
+
+	int i;
+	for (i = 0; i < moves->length; i++)
+		split.values[i] = INT_MIN;	// Moves left unsearched after a fail high
+
+	SDL_Thread* threads[MAX_SEARCH_THREADS];
+	for (i = 0; i < numOfThreads; i++)
+	{
+		threads[i] = SDL_CreateThread(searchRootMovesWorker, &split);
+		if (threads[i] == NULL)
+			break;	// Search with the threads already running
+	}
+
+	int numOfRunningThreads = i;
+	if (numOfRunningThreads == 0)
+		searchRootMovesWorker(&split);	// Search on this thread
+	for (i = 0; i < numOfRunningThreads; i++)
+		SDL_WaitThread(threads[i], NULL);
+
+	SDL_DestroyMutex(split.lock);
+	context->nodes += split.nodes;
+	context->qnodes += split.qnodes;
+	sumTranspositionTableStats(&(context->ttStats), &(split.ttStats));
+	if (split.isStopped)
+	{
+		context->isStopped = true;
+		return -1;
+	}
+
+	context->pvLengths[0] = split.pvLength;
+	for (i = 0; i < split.pvLength; i++)
+		context->pvTable[0][i] = split.pv[i];
+
+	// The first move with the best value, as in the serial search
+	*bestValue = split.bestValue;
+	for (i = 0; i < moves->length; i++)
+	{
+		if (split.values[i] == split.bestValue)
+			return i;
+	}
+
+	return 0;	// Fail low
+}
+
+/*
+ * The body of a Lazy SMP helper thread: iterative deepening over the whole root from its start depth,
+ * until the main search is done. The results of the helper are dropped, only its table entries remain.
+ */
+int lazySmpHelperWorker(void* data)
+{
+	LazySmpHelper* helper = (LazySmpHelper*)data;
+	SearchContext* context = &(helper->context);
+
+	int depth, value;
+	for (depth = helper->startDepth; (depth <= helper->maxDepth) && (!context->isStopped); depth++)
+	{
+		context->depth = depth;
+		searchRootMovesSerial(context, &(helper->state), &(helper->moves), helper->isABlack, INT_MIN, INT_MAX, &value);
+	}
+
+	struct LazySmp* lazySmp = context->lazySmp;
+	SDL_mutexP(lazySmp->lock);
+	lazySmp->nodes += context->nodes;
+	lazySmp->qnodes += context->qnodes;
+	sumTranspositionTableStats(&(lazySmp->ttStats), &(context->ttStats));
+	SDL_mutexV(lazySmp->lock);
+
+	return 0;
+}
+
+/*
+ * Start the helper threads of a Lazy SMP search of the root, one less than the number of search threads
+ * (the calling thread runs the main search). Returns NULL if no helper could be started.
+ */
+struct LazySmp* startLazySmpHelpers(const SearchContext* context, const BoardState* state, const MoveBuffer* moves,
+									bool isABlack, int maxDepth)
+{
+	if (moves->length == 0)
+		return NULL;
+
+	// The helpers are only an optimization, so if they can't be started the main search runs alone
+	struct LazySmp* lazySmp = (struct LazySmp*)malloc(sizeof(struct LazySmp));
+	if (lazySmp == NULL)
+		return NULL;
+
+	lazySmp->lock = SDL_CreateMutex();
+	if (lazySmp->lock == NULL)
+	{
+		free(lazySmp);
+		return NULL;
+	}
+
+	lazySmp->isStopped = false;
+	lazySmp->nodes = 0;
+	lazySmp->qnodes = 0;
+	clearTranspositionTableStats(&(lazySmp->ttStats));
+
+	int i, j;
+	for (i = 0; i < g_numOfSearchThreads - 1; i++)
+	{
+		LazySmpHelper* helper = &(lazySmp->helpers[i]);
+		initSearchContext(&(helper->context), 1);
+		helper->context.endTime = context->endTime;	// In case the main search is stopped by other limits
+		helper->context.nodeLimit = context->nodeLimit;
+		helper->context.isMoveOrdering = context->isMoveOrdering;
+		helper->context.isPvs = context->isPvs;
+		helper->context.isQuiescence = context->isQuiescence;	// The table must hold scores of the same search
+		helper->context.isNullMovePruning = context->isNullMovePruning;
+		helper->context.isLateMoveReduction = context->isLateMoveReduction;
+		helper->context.evaluate = context->evaluate;
+		helper->context.lazySmp = lazySmp;
+		helper->state = *state;
+		helper->isABlack = isABlack;
+
+		// Half of the helpers search one ply deeper than the others, and each starts with other root moves
+		helper->startDepth = mini(1 + ((i + 1) % 2), maxDepth);
+		helper->maxDepth = maxDepth;
+		helper->moves.length = moves->length;
+		for (j = 0; j < moves->length; j++)
+			helper->moves.moves[j] = moves->moves[(j + i + 1) % moves->length];
+
+		lazySmp->threads[i] = SDL_CreateThread(lazySmpHelperWorker, helper);
+		if (lazySmp->threads[i] == NULL)
+			break;	// Search with the helpers already running
+	}
+
+	lazySmp->numOfHelpers = i;
+	if (lazySmp->numOfHelpers == 0)
+	{
+		SDL_DestroyMutex(lazySmp->lock);
+		free(lazySmp);
+		return NULL;
+	}
+
+	return lazySmp;
+}
+
+/* Stop the helper threads once the main search is done, and add their boards and statistics to its context. */
+void stopLazySmpHelpers(struct LazySmp* lazySmp, SearchContext* context)
+{
+	SDL_mutexP(lazySmp->lock);
+	lazySmp->isStopped = true;
+	SDL_mutexV(lazySmp->lock);
+
+	int i;
+	for (i = 0; i < lazySmp->numOfHelpers; i++)
+		SDL_WaitThread(lazySmp->threads[i], NULL);
+
+	context->nodes += lazySmp->nodes;
+	context->qnodes += lazySmp->qnodes;
+	sumTranspositionTableStats(&(context->ttStats), &(lazySmp->ttStats));
+
+	SDL_DestroyMutex(lazySmp->lock);
+	free(lazySmp);
+}
+
+/* Returns true once the main search of the Lazy SMP search is done. */
+bool isLazySmpStopped(struct LazySmp* lazySmp)
+{
+	SDL_mutexP(lazySmp->lock);
+	bool isStopped = lazySmp->isStopped;
+	SDL_mutexV(lazySmp->lock);
+
+	return isStopped;
+}
\ No newline at end of file
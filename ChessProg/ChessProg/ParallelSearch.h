@@ -0,0 +1,114 @@
+#ifndef PARALLEL_SEARCH_
+#define PARALLEL_SEARCH_
+
+#include <SDL.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+#include "Types.h"
+#include "BoardManager.h"
+#include "Minimax.h"
+
+#define MAX_SEARCH_THREADS 64	// Maximum number of threads the user may configure
+#define WRONG_NUM_OF_THREADS "Wrong value for number of search threads. The value should be between 1 to 64\n"
+#define ROOT_SPLIT_MODE "root_split"
+#define LAZY_SMP_MODE "lazy_smp"
+#define WRONG_PARALLEL_MODE "Wrong parallel search mode. The value should be root_split or lazy_smp\n"
+
+/* How the search threads share the work of a search. */
+typedef enum
+{
+	PARALLEL_ROOT_SPLIT,	// The root moves are split between the threads
+	PARALLEL_LAZY_SMP		// All the threads search the whole root, sharing only the transposition table
+} ParallelMode;
+
+/*
+ * The state shared by the threads of a root split search. The root moves are handed out one at a time,
+ * and every thread searches its moves on its own copy of the board.
+ */
+typedef struct
+{
+	SDL_mutex* lock;				// Guards all the fields below, except the read only ones
+	const SearchContext* context;	// The search the threads split (read only)
+	const BoardState* rootState;	// The board of the root (read only)
+	const MoveBuffer* moves;		// The root moves (read only)
+	bool isABlack;					// The root player (read only)
+	int alpha;						// The window of the search (read only)
+	int beta;
+	unsigned long long nodeLimit;	// The boards limit of every thread, 0 for no limit (read only)
+	int nextMoveIndex;				// Index of the next root move to hand out
+	int bestValue;					// The best value found so far (alpha if none), the bound all the threads share
+	int values[MAX_MOVES];			// values[i] is the value of root move i, or lower than bestValue
+	CompactMove pv[MAX_SEARCH_PLY];	// The principal variation of the first move with the best value (if above alpha)
+	int pvLength;					// Number of moves in pv, 0 if no move is above alpha
+	int pvMoveIndex;				// The index of the root move pv starts with
+	unsigned long long nodes;		// Number of boards visited by the finished threads
+	unsigned long long qnodes;		// Number of these boards visited by quiescence searches
+	TTStats ttStats;				// Transposition table usage of the finished threads
+	bool isStopped;					// True once a thread was stopped by the limits of the search
+} RootSplit;
+
+/* A helper thread of a Lazy SMP search, with its own copy of the search. */
+typedef struct
+{
+	SearchContext context;			// The search of the helper. Its lazySmp field points to the shared state
+	BoardState state;				// The helper's copy of the root board
+	MoveBuffer moves;				// The root moves, rotated so every helper starts with different moves
+	bool isABlack;					// The root player
+	int startDepth;					// The first iteration of the helper, staggered between the helpers
+	int maxDepth;					// The last iteration of the helper
+} LazySmpHelper;
+
+/*
+ * The state shared by the threads of a Lazy SMP search: the main search and the helpers that search the same root
+ * at staggered depths. The threads communicate only through the transposition table, where the helpers leave
+ * results the main search can use. The helpers run until the main search is done.
+ */
+struct LazySmp
+{
+	SDL_mutex* lock;				// Guards isStopped, nodes, qnodes and ttStats
+	bool isStopped;					// True once the main search is done
+	int numOfHelpers;				// Number of running helpers
+	SDL_Thread* threads[MAX_SEARCH_THREADS];
+	LazySmpHelper helpers[MAX_SEARCH_THREADS];
+	unsigned long long nodes;		// Number of boards visited by the finished helpers
+	unsigned long long qnodes;		// Number of these boards visited by quiescence searches
+	TTStats ttStats;				// Transposition table usage of the finished helpers
+};
+
+/* Set the number of search threads. 1 searches on the calling thread only. */
+void setNumOfSearchThreads(int numOfThreads);
+
+/* Returns the number of search threads. */
+int getNumOfSearchThreads();
+
+/* Set how the search threads share the work. */
+void setParallelMode(ParallelMode mode);
+
+/* Returns how the search threads share the work. */
+ParallelMode getParallelMode();
+
+/*
+ * Search the root moves with the depth and limits of the context, within the window (alpha, beta), on several
+ * threads, each with its own board. Without null move pruning and late move reductions, returns the same move and
+ * value as a serial search (see searchRootMovesSerial): the index of the first move with the best value, or -1 if the
+ * search was stopped by its limits. A selective search depends on the order the threads fill the table in.
+ * The boards of all the threads are added to the context, and the principal variation to its PV table.
+ * If the threads can't be created, the moves are searched on the calling thread.
+ */
+int searchRootMovesParallel(SearchContext* context, BoardState* state, const MoveBuffer* moves, bool isABlack,
+							int alpha, int beta, int* bestValue);
+
+/*
+ * Start the helper threads of a Lazy SMP search of the root, one less than the number of search threads
+ * (the calling thread runs the main search). Returns NULL if no helper could be started.
+ */
+struct LazySmp* startLazySmpHelpers(const SearchContext* context, const BoardState* state, const MoveBuffer* moves,
+									bool isABlack, int maxDepth);
+
+/* Stop the helper threads once the main search is done, and add their boards and statistics to its context. */
+void stopLazySmpHelpers(struct LazySmp* lazySmp, SearchContext* context);
+
+/* Returns true once the main search of the Lazy SMP search is done. */
+bool isLazySmpStopped(struct LazySmp* lazySmp);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PIECE_SQUARE_TABLES_
+#define PIECE_SQUARE_TABLES_
+
+#include "Types.h"
+#include "BitBoard.h"
+
+/*
+ * Piece-square tables: the positional score of every piece type on every square (in hundredths of a pawn, as the
+ * scores of the search), once for the midgame and once for the endgame. The positional score of a board is tapered
+ * between the two by the game phase, which is counted from the knights, bishops, rooks and queens left on the board.
+ *
+ * The tables are given from the side of the white player, with row 8 first (as the board is printed), so the table
+ * index of a square is mirrored for the white player (see PST_INDEX).
+ */
+
+/* The weight of each piece type in the game phase. The phase of the starting board is MAX_GAME_PHASE. */
+#define KNIGHT_PHASE 1
+#define BISHOP_PHASE 1
+#define ROOK_PHASE 2
+#define QUEEN_PHASE 4
+#define MAX_GAME_PHASE 24
+
+extern const int g_midgameTables[NUM_OF_PIECE_TYPES][NUM_OF_SQUARES];
+extern const int g_endgameTables[NUM_OF_PIECE_TYPES][NUM_OF_SQUARES];
+extern const int g_piecePhases[NUM_OF_PIECE_TYPES];
+
+/* Returns the index in the tables of a square with a piece of the black (isBlack == true) or white player. */
+#define PST_INDEX(square, isBlack) ((isBlack) ? (square) : ((square) ^ 56))
+
+/* Returns the midgame / endgame score of a soldier ('m', 'M', 'b', ...) standing on the square. */
+#define PST_MIDGAME_SCORE(soldier, square) \
+	(g_midgameTables[getPieceType(soldier)][PST_INDEX((square), isBlackSoldier(soldier))])
+#define PST_ENDGAME_SCORE(soldier, square) \
+	(g_endgameTables[getPieceType(soldier)][PST_INDEX((square), isBlackSoldier(soldier))])
+
+/* Returns the weight of the soldier in the game phase. */
+#define SOLDIER_PHASE(soldier) (g_piecePhases[getPieceType(soldier)])
+
+#endif
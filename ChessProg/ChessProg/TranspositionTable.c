@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "TranspositionTable.h"
+
+#define BYTES_IN_MB (1024 * 1024)
+
+/* Packing of a TTEntry (without its key) to the data word of a slot. */
+#define PACK_TT_DATA(score, bestMove, depth, bound) \
+	(((uint64_t)(uint32_t)(score)) | ((uint64_t)(bestMove) << 32) | ((uint64_t)(unsigned char)(depth) << 48) | \
+	 ((uint64_t)(unsigned char)(bound) << 56))
+#define TT_DATA_SCORE(data) ((int)(uint32_t)((data) & 0xFFFFFFFFULL))
+#define TT_DATA_BEST_MOVE(data) ((CompactMove)(((data) >> 32) & 0xFFFF))
+#define TT_DATA_DEPTH(data) ((char)(((data) >> 48) & 0xFF))
+#define TT_DATA_BOUND(data) ((char)(((data) >> 56) & 0xFF))
+
+/*
+ * Relaxed atomic access to a word of a slot. The words need no ordering between them (a torn slot fails the key
+ * check), only loads and stores that are never split. MSVC makes aligned 64 bit volatile accesses atomic on x64.
+ */
+#if defined(__GNUC__)
+#define TT_LOAD(word) __atomic_load_n(&(word), __ATOMIC_RELAXED)
+#define TT_STORE(word, value) __atomic_store_n(&(word), (value), __ATOMIC_RELAXED)
+#else
+#define TT_LOAD(word) (*(const volatile uint64_t*)&(word))
+#define TT_STORE(word, value) (*(volatile uint64_t*)&(word) = (value))
+#endif
+
+TTBucket* g_ttBuckets = NULL;				// The table, NULL until first use
+unsigned long g_ttNumOfBuckets = 0;			// A power of two
+int g_ttSizeInMB = TT_DEFAULT_SIZE_MB;		// Configured size of the table
+TTStats g_ttStats = { 0, 0, 0 };
+
+/*
+ * Set the size of the table in megabytes, rounded down to a power of two number of buckets.
+ * All the stored entries are discarded. Returns false on an allocation error, in which case the table and its size
+ * are left as they were.
+ */
+bool setTranspositionTableSize(int sizeInMB)
+{
+	// The largest power of two number of buckets that fits the requested size
+	unsigned long maxBuckets = (unsigned long)(((unsigned long long)sizeInMB * BYTES_IN_MB) / sizeof(TTBucket));
+	unsigned long numOfBuckets = 1;
+	while ((numOfBuckets * 2) <= maxBuckets)
+		numOfBuckets *= 2;
+
+	TTBucket* buckets = (TTBucket*)malloc(sizeof(TTBucket) * numOfBuckets);
+	if (buckets == NULL)
+	{
+		printf("Error: standard function malloc has failed");
+		return false;
+	}
+
+	freeTranspositionTable();
+	g_ttBuckets = buckets;
+	g_ttNumOfBuckets = numOfBuckets;
+	g_ttSizeInMB = sizeInMB;
+	clearTranspositionTable();
+	return true;
+}
+
+/* Discard all the entries of the table and reset its statistics. */
+void clearTranspositionTable()
+{
+	unsigned long i;
+	int j;
+	for (i = 0; i < g_ttNumOfBuckets; i++)
+	{
+		for (j = 0; j < TT_BUCKET_SIZE; j++)
+		{
+			TT_STORE(g_ttBuckets[i].slots[j].keyXorData, 0);
+			TT_STORE(g_ttBuckets[i].slots[j].data, 0);	// Vacant (TT_BOUND_NONE)
+		}
+	}
+
+	clearTranspositionTableStats(&g_ttStats);
+}
+
+/* Release the memory of the table. */
+void freeTranspositionTable()
+{
+	free(g_ttBuckets);
+	g_ttBuckets = NULL;
+	g_ttNumOfBuckets = 0;
+}
+
+/*
+ * Allocate the table with the configured size, if it wasn't allocated yet. Called before every search.
+ * Returns false on an allocation error.
+ */
+bool initTranspositionTable()
+{
+	if (g_ttBuckets == NULL)
+		return setTranspositionTableSize(g_ttSizeInMB);
+
+	return true;
+}
+
+/*
+ * Read the slot into entry. Each word is read once, so a concurrent write can't change the data after the check.
+ * Returns true if the slot holds an entry (that may belong to another position), false if it is vacant or torn.
+ */
+bool readTranspositionTableSlot(const TTSlot* slot, TTEntry* entry)
+{
+	uint64_t data = TT_LOAD(slot->data);
+	uint64_t keyXorData = TT_LOAD(slot->keyXorData);
+
+	entry->key = keyXorData ^ data;
+	entry->score = TT_DATA_SCORE(data);
+	entry->bestMove = TT_DATA_BEST_MOVE(data);
+	entry->depth = TT_DATA_DEPTH(data);
+	entry->bound = TT_DATA_BOUND(data);
+
+	return (entry->bound != TT_BOUND_NONE);
+}
+
+/*
+ * Look for the position in the table. Returns true and copies the entry to result if it was found.
+ * The probe is counted in the given statistics.
+ */
+bool probeTranspositionTable(ZobristKey key, TTEntry* result, TTStats* stats)
+{
+	if (g_ttBuckets == NULL)
+		return false;
+
+	TTBucket* bucket = &(g_ttBuckets[key & (g_ttNumOfBuckets - 1)]);
+
+	int i;
+	for (i = 0; i < TT_BUCKET_SIZE; i++)
+	{
+		// A torn slot gets a key no position has (but with a negligible chance), so it is never found
+		if (readTranspositionTableSlot(&(bucket->slots[i]), result) && (result->key == key))
+		{
+			stats->hits++;
+			return true;
+		}
+	}
+
+	stats->misses++;
+	return false;
+}
+
+/*
+ * Store a search result of the position, replacing the shallowest entry of the bucket if it is full.
+ * An overwrite of another position is counted in the given statistics.
+ */
+void storeTranspositionTable(ZobristKey key, int depth, TTBound bound, int score, CompactMove bestMove,
+							 TTStats* stats)
+{
+	if (g_ttBuckets == NULL)
+		return;
+
+	TTBucket* bucket = &(g_ttBuckets[key & (g_ttNumOfBuckets - 1)]);
+
+	// Prefer the entry of the same position, then a vacant entry, then the shallowest entry
+	TTSlot* replaced = NULL;
+	TTEntry replacedEntry;
+	bool isReplacedOccupied = false;
+	int i;
+	for (i = 0; i < TT_BUCKET_SIZE; i++)
+	{
+		TTEntry entry;
+		bool isOccupied = readTranspositionTableSlot(&(bucket->slots[i]), &entry);
+		if (isOccupied && (entry.key == key))
+		{
+			replaced = &(bucket->slots[i]);
+			replacedEntry = entry;
+			isReplacedOccupied = true;
+			break;
+		}
+
+		if ((replaced == NULL) || (!isOccupied) || (isReplacedOccupied && (entry.depth < replacedEntry.depth)))
+		{
+			replaced = &(bucket->slots[i]);
+			replacedEntry = entry;
+			isReplacedOccupied = isOccupied;
+		}
+	}
+
+	if (isReplacedOccupied && (replacedEntry.key != key))
+		stats->overwrites++;
+
+	uint64_t data = PACK_TT_DATA(score, bestMove, depth, bound);
+	TT_STORE(replaced->keyXorData, key ^ data);
+	TT_STORE(replaced->data, data);
+}
+
+/* Reset the given statistics. */
+void clearTranspositionTableStats(TTStats* stats)
+{
+	stats->hits = 0;
+	stats->misses = 0;
+	stats->overwrites = 0;
+}
+
+/* Add the given statistics to the total statistics. */
+void sumTranspositionTableStats(TTStats* total, const TTStats* stats)
+{
+	total->hits += stats->hits;
+	total->misses += stats->misses;
+	total->overwrites += stats->overwrites;
+}
+
+/* Add the statistics of a search to the usage statistics of the table. Called once the search is done. */
+void addTranspositionTableStats(const TTStats* stats)
+{
+	sumTranspositionTableStats(&g_ttStats, stats);
+}
+
+/* Returns the usage statistics of the table. */
+TTStats getTranspositionTableStats()
+{
+	return g_ttStats;
+}
+
+/* Returns the size of the table in megabytes. */
+int getTranspositionTableSize()
+{
+	return g_ttSizeInMB;
+}
\ No newline at end of file
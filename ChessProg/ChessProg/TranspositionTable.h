@@ -0,0 +1,110 @@
+#ifndef TRANSPOSITION_TABLE_
+#define TRANSPOSITION_TABLE_
+
+#include "Types.h"
+#include "BoardManager.h"
+#include "Zobrist.h"
+
+#define TT_DEFAULT_SIZE_MB 16	// Size of the table before the user configures it
+#define TT_MAX_SIZE_MB 1024		// Maximum size the user may configure
+#define TT_BUCKET_SIZE 4		// Number of entries sharing a single table index
+#define WRONG_TT_SIZE "Wrong value for transposition table size. The value should be between 1 to 1024\n"
+
+/* The kind of score kept in a table entry. */
+typedef enum
+{
+	TT_BOUND_NONE,		// Vacant entry
+	TT_BOUND_EXACT,		// The score is the exact minimax score of the position
+	TT_BOUND_LOWER,		// The search failed high, the real score is at least the score
+	TT_BOUND_UPPER		// The search failed low, the real score is at most the score
+} TTBound;
+
+/*
+ * A single search result. The score is given for the player to move in the position
+ * (positive is good for that player), so it doesn't depend on the level the position was met at.
+ */
+typedef struct
+{
+	ZobristKey key;			// Zobrist key of the position
+	int score;				// Score of the position for the player to move
+	CompactMove bestMove;	// The best move found in the position
+	char depth;				// Number of plies searched below the position
+	char bound;				// TTBound of the score
+} TTEntry;
+
+/*
+ * A table entry as it is kept in the table: the entry packed to a single 64 bit word, and the key XORed with it.
+ * Search threads access the table without locks, so a slot may be read while another thread writes it. Such a
+ * torn slot (the words of two different writes) fails the key check and is treated as a miss.
+ */
+typedef struct
+{
+	uint64_t keyXorData;	// The zobrist key XOR data, accessed with relaxed atomic loads and stores only
+	uint64_t data;			// The packed TTEntry fields, 0 for a vacant slot, accessed like keyXorData
+} TTSlot;
+
+/* Entries whose keys map to the same index. Replacement is decided among the entries of a bucket. */
+typedef struct
+{
+	TTSlot slots[TT_BUCKET_SIZE];
+} TTBucket;
+
+/*
+ * Statistics of the table usage. Every search counts its own statistics (so threads never share counters)
+ * and adds them to the table's when it is done. Reset with the table.
+ */
+typedef struct
+{
+	unsigned long long hits;		// Probes that found the position
+	unsigned long long misses;		// Probes that did not find the position
+	unsigned long long overwrites;	// Stores that evicted an entry of another position
+} TTStats;
+
+/*
+ * Set the size of the table in megabytes, rounded down to a power of two number of buckets.
+ * All the stored entries are discarded. Returns false on an allocation error, in which case the table and its size
+ * are left as they were.
+ */
+bool setTranspositionTableSize(int sizeInMB);
+
+/*
+ * Allocate the table with the configured size, if it wasn't allocated yet. Called before every search.
+ * Returns false on an allocation error.
+ */
+bool initTranspositionTable();
+
+/* Discard all the entries of the table and reset its statistics. */
+void clearTranspositionTable();
+
+/* Release the memory of the table. */
+void freeTranspositionTable();
+
+/*
+ * Look for the position in the table. Returns true and copies the entry to result if it was found.
+ * The probe is counted in the given statistics.
+ */
+bool probeTranspositionTable(ZobristKey key, TTEntry* result, TTStats* stats);
+
+/*
+ * Store a search result of the position, replacing the shallowest entry of the bucket if it is full.
+ * An overwrite of another position is counted in the given statistics.
+ */
+void storeTranspositionTable(ZobristKey key, int depth, TTBound bound, int score, CompactMove bestMove,
+							 TTStats* stats);
+
+/* Reset the given statistics. */
+void clearTranspositionTableStats(TTStats* stats);
+
+/* Add the given statistics to the total statistics. */
+void sumTranspositionTableStats(TTStats* total, const TTStats* stats);
+
+/* Add the statistics of a search to the usage statistics of the table. Called once the search is done. */
+void addTranspositionTableStats(const TTStats* stats);
+
+/* Returns the usage statistics of the table. */
+TTStats getTranspositionTableStats();
+
+/* Returns the size of the table in megabytes. */
+int getTranspositionTableSize();
+
+#endif
@@ -1,4 +1,12 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 199309L	// For clock_gettime, must come before the system headers
+#include <time.h>
+#endif
 #include "Types.h"
+#include "Evaluation.h"
+#include "TranspositionTable.h"
 
 /* -- Globals Definition -- */
 
@@ -17,14 +25,35 @@ bool g_isUserBlack = false;
 /* Is the next player the black color (true) or white color (false). Default to white. */
 bool g_isNextPlayerBlack = false;
 
+/* The castling rights of the game board (flags of the castlings left). Default to ALL_CASTLING_RIGHTS. */
+int g_castlingRights = ALL_CASTLING_RIGHTS;
+
+/* The square of the game board a pawn may be eaten en passant on in the next move. Default to NO_EN_PASSANT_SQUARE. */
+int g_enPassantSquare = NO_EN_PASSANT_SQUARE;
+
 /* A buffer allocated for reading user input. The user's command will not exceed 50 characters. */
 char g_inputLine[LINE_LENGTH] = { 0 };
 
 /* True if there was an allocation error somewhere in the program (would cause an exit). Else false. */
 bool g_memError = false;
 
-/* The boards counter for the Minimax algorithm with difficulty best. */
-int g_boardsCounter = 0;
+/* Time limit (in milliseconds) of a single search request (computer move, score or best moves). 0 for no limit. */
+int g_searchTimeLimit = DEFAULT_SEARCH_TIME_LIMIT_MS;
+
+/* Limit on the number of boards a single search request may visit. 0 for no limit. */
+int g_searchNodeLimit = 0;
+
+/* Are the leaves of the search extended with a quiescence search (captures and promotions only). Default to true. */
+bool g_isQuiescence = true;
+
+/* Is the search pruned by null moves (passing the turn to see if the opponent is still lost). Default to true. */
+bool g_isNullMovePruning = true;
+
+/* Are quiet moves ordered late searched with a reduced depth first. Default to true. */
+bool g_isLateMoveReduction = true;
+
+/* Number of best moves ranked by a request for the top moves (1 to MAX_MULTI_PV). Default to DEFAULT_MULTI_PV. */
+int g_multiPv = DEFAULT_MULTI_PV;
 
 
 /* -- General functions -- */
@@ -37,7 +66,17 @@ void initGlobals()
 	g_isDifficultyBest = false;
 	g_isUserBlack = false;
 	g_isNextPlayerBlack = false;
+	g_castlingRights = ALL_CASTLING_RIGHTS;
+	g_enPassantSquare = NO_EN_PASSANT_SQUARE;
 	g_memError = false;
+	g_searchTimeLimit = DEFAULT_SEARCH_TIME_LIMIT_MS;
+	g_searchNodeLimit = 0;
+	g_isQuiescence = true;
+	g_isNullMovePruning = true;
+	g_isLateMoveReduction = true;
+	g_multiPv = DEFAULT_MULTI_PV;
+	setEvaluatorType(DEFAULT_EVALUATOR);
+	clearTranspositionTable();	// The stored scores may be of other search settings
 }
 
 /** A general max function for integers (that doesn't use macros) */
@@ -56,4 +95,16 @@ int mini(int a, int b)
 		return a;
 	else
 		return b;
+}
+
+/** Returns a wall clock time in milliseconds, to measure time spans (the starting point is unspecified). */
+long long getTimeInMs()
+{
+#ifdef _WIN32
+	return (long long)GetTickCount64();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((long long)now.tv_sec * 1000) + (now.tv_nsec / 1000000);
+#endif
 }
\ No newline at end of file
@@ -31,14 +31,35 @@ typedef enum { false, true } bool;
 #define BLACK_K 'K'
 #define EMPTY ' '
 #define BOARD_SIZE 8
+
+/** Castling rights: flags of the castlings the players may still do (their king and rook haven't moved yet) */
+#define WHITE_KINGSIDE_CASTLING 1
+#define WHITE_QUEENSIDE_CASTLING 2
+#define BLACK_KINGSIDE_CASTLING 4
+#define BLACK_QUEENSIDE_CASTLING 8
+#define NO_CASTLING_RIGHTS 0
+#define ALL_CASTLING_RIGHTS 15
+#define NUM_OF_CASTLING_RIGHTS 16	// Number of combinations of the flags
+
+/** The en passant square when the last move was not a double pawn push (squares are indexed by SQUARE_INDEX) */
+#define NO_EN_PASSANT_SQUARE -1
 #define INVALID_POSITION_INDEX -1
 #define MAX_ARGS 7			// Max number of args supported by shell
 #define LINE_LENGTH 50		// Shell "buffer" size used to read user input
-#define MAX_DEPTH 4			// Maximum depth miniMax algorithm depth can be
+#define MAX_DEPTH 20			// Maximum depth miniMax algorithm depth can be
+#define MAX_MULTI_PV 10		// Maximum number of best moves a multi-PV search may rank
+#define DEFAULT_MULTI_PV 3
+#define DEFAULT_SEARCH_TIME_LIMIT_MS 10000	// Default time limit of a single search request (deep depths may take long)
 #define MAX_SOLDIERS 16		// Maximum number of soldiers per player
 #define GAME_MODE_2_PLAYERS 1
 #define GAME_MODE_PLAYER_VS_AI 2
-#define WRONG_MINIMAX_DEPTH "Wrong value for minimax depth. The value should be between 1 to 4\n"
+#define WRONG_MINIMAX_DEPTH "Wrong value for minimax depth. The value should be between 1 to 20\n"
+#define WRONG_TIME_LIMIT "Wrong value for search time limit. The value should be a non negative number of milliseconds\n"
+#define WRONG_NODE_LIMIT "Wrong value for search boards limit. The value should be a non negative number of boards\n"
+#define WRONG_QUIESCENCE "Wrong value for quiescence. The value should be on or off\n"
+#define WRONG_NULL_MOVE "Wrong value for null move pruning. The value should be on or off\n"
+#define WRONG_LMR "Wrong value for late move reductions. The value should be on or off\n"
+#define WRONG_MULTI_PV "Wrong value for number of top moves. The value should be between 1 to 10\n"
 #define WRONG_FILE_NAME "Wrong file name\n"
 #define WRONG_POSITION "Invalid position on the board\n"
 #define WRONG_SET "Setting this piece creates an invalid board\n"  
@@ -91,8 +112,13 @@ typedef struct
 	char promotion;					// EMPTY if no promotion for a pawn occured in this step.
 									// Otherwise contains the promotion: 'b', 'B', 'r', 'R', 'n', 'N', 'q', 'Q'.
 	bool isEnemyRemovedInStep;		// True if an enemy piece was eaten on this step. False if not.
-									// The position of the enemy eaten is the same as endPos.
+									// The position of the enemy eaten is the same as endPos, except en passant.
 	char removedType;				// Types of enemy soldier removed. Relevant only if isEnemyRemovedInStep==true.
+	bool isCastling;				// True if the king castles: it moves two squares and the rook jumps over it.
+	bool isEnPassant;				// True if a pawn was eaten en passant. It stood in the row of startPos and the
+									// column of endPos.
+	int prevCastlingRights;			// The castling rights before the step, restored when the step is undone.
+	int prevEnPassantSquare;		// The en passant square before the step, restored when the step is undone.
 } GameStep;
 
 
@@ -113,14 +139,35 @@ extern bool g_isUserBlack;
 /* Is the next player the black color (true) or white color (false). Default to white. */
 extern bool g_isNextPlayerBlack;
 
+/* The castling rights of the game board (flags of the castlings left). Default to ALL_CASTLING_RIGHTS. */
+extern int g_castlingRights;
+
+/* The square of the game board a pawn may be eaten en passant on in the next move. Default to NO_EN_PASSANT_SQUARE. */
+extern int g_enPassantSquare;
+
 /* A buffer allocated for reading user input. The user's command will not exceed 50 characters. */
 extern char g_inputLine[LINE_LENGTH];
 
 /* True if there was an allocation error somewhere in the program (would cause an exit). Else false. */
 extern bool g_memError;
 
-/* The boards counter for the Minimax algorithm with difficulty best. */
-extern int g_boardsCounter;
+/* Time limit (in milliseconds) of a single search request (computer move, score or best moves). 0 for no limit. */
+extern int g_searchTimeLimit;
+
+/* Limit on the number of boards a single search request may visit. 0 for no limit. */
+extern int g_searchNodeLimit;
+
+/* Are the leaves of the search extended with a quiescence search (captures and promotions only). Default to true. */
+extern bool g_isQuiescence;
+
+/* Is the search pruned by null moves (passing the turn to see if the opponent is still lost). Default to true. */
+extern bool g_isNullMovePruning;
+
+/* Are quiet moves ordered late searched with a reduced depth first. Default to true. */
+extern bool g_isLateMoveReduction;
+
+/* Number of best moves ranked by a request for the top moves (1 to MAX_MULTI_PV). Default to DEFAULT_MULTI_PV. */
+extern int g_multiPv;
 
 /* -- General functions -- */
 
@@ -133,4 +180,7 @@ int maxi(int a, int b);
 /** A general min function for integers (that doesn't use macros) */
 int mini(int a, int b);
 
+/** Returns a wall clock time in milliseconds, to measure time spans (the starting point is unspecified). */
+long long getTimeInMs();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "Zobrist.h"
+
+/* Fixed seed of the key generator, so keys (and debug output) are reproducible between runs. */
+#define ZOBRIST_SEED 0x9E3779B97F4A7C15ULL
+
+ZobristKey g_zobristPieceKeys[NUM_OF_PLAYERS][NUM_OF_PIECE_TYPES][NUM_OF_SQUARES];
+ZobristKey g_zobristBlackTurnKey = 0;
+ZobristKey g_zobristCastlingKeys[NUM_OF_CASTLING_RIGHTS];
+ZobristKey g_zobristEnPassantKeys[BOARD_SIZE];
+
+static bool isZobristKeysReady = false;
+
+/* Returns the next number of a xorshift64* pseudo random sequence. */
+ZobristKey nextRandomKey(ZobristKey* state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return (*state * 0x2545F4914F6CDD1DULL);
+}
+
+/*
+ * Fill the random key tables. The keys are generated from a fixed seed, so they are the same on every run.
+ * Called by computeZobristKey, so the tables are ready before any incremental update takes place.
+ */
+void initZobristKeys()
+{
+	if (isZobristKeysReady)
+		return;
+
+	ZobristKey state = ZOBRIST_SEED;
+	int player, type, square;
+	for (player = 0; player < NUM_OF_PLAYERS; player++)
+	{
+		for (type = 0; type < NUM_OF_PIECE_TYPES; type++)
+		{
+			for (square = 0; square < NUM_OF_SQUARES; square++)
+			{
+				g_zobristPieceKeys[player][type][square] = nextRandomKey(&state);
+			}
+		}
+	}
+
+	g_zobristBlackTurnKey = nextRandomKey(&state);
+
+	// A key per castling flag, so a combination of rights is keyed by the xor of the keys of its flags
+	ZobristKey flagKeys[NUM_OF_CASTLING_RIGHTS];
+	int rights, flag;
+	for (flag = 1; flag < NUM_OF_CASTLING_RIGHTS; flag <<= 1)
+		flagKeys[flag] = nextRandomKey(&state);
+	for (rights = 0; rights < NUM_OF_CASTLING_RIGHTS; rights++)
+	{
+		g_zobristCastlingKeys[rights] = 0;
+		for (flag = 1; flag < NUM_OF_CASTLING_RIGHTS; flag <<= 1)
+		{
+			if (rights & flag)
+				g_zobristCastlingKeys[rights] ^= flagKeys[flag];
+		}
+	}
+
+	int column;
+	for (column = 0; column < BOARD_SIZE; column++)
+		g_zobristEnPassantKeys[column] = nextRandomKey(&state);
+
+	isZobristKeysReady = true;
+}
+
+/* Computes the key of the char board from scratch (used for boards that were set or loaded by the user). */
+ZobristKey computeZobristKey(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int castlingRights,
+							 int enPassantSquare)
+{
+	initZobristKeys();
+
+	ZobristKey key = isBlackTurn ? g_zobristBlackTurnKey : 0;
+	key ^= g_zobristCastlingKeys[castlingRights] ^ ZOBRIST_EN_PASSANT_KEY(enPassantSquare);
+
+	int i, j; // i = row, j = column
+	for (i = 0; i < BOARD_SIZE; i++)
+	{
+		for (j = 0; j < BOARD_SIZE; j++)
+		{
+			if (board[i][j] != EMPTY)
+				key ^= ZOBRIST_SOLDIER_KEY(board[i][j], SQUARE_INDEX(i, j));
+		}
+	}
+
+	return key;
+}
@@ -0,0 +1,45 @@
+#ifndef ZOBRIST_
+#define ZOBRIST_
+
+#include <stdint.h>
+#include "Types.h"
+#include "BitBoard.h"
+
+/*
+ * A 64 bit hash of a game position (Zobrist hashing).
+ * Every (player, piece type, square) triplet, the black player's turn, every castling right and every column of
+ * an en passant square get a random key, and the key of a position is the xor of the keys of its parts. Moving a
+ * piece therefore changes the key with a few xors, which lets doStep / undoStep keep the key of the board up to date incrementally.
+ *
+ * Compile with -DZOBRIST_DEBUG to cross-check the incremental key (and the evaluation terms of the board state)
+ * against a full computation on every step.
+ */
+typedef uint64_t ZobristKey;
+
+/* The random keys of each piece on each square, and the key xored in when the black player is next to move. */
+extern ZobristKey g_zobristPieceKeys[NUM_OF_PLAYERS][NUM_OF_PIECE_TYPES][NUM_OF_SQUARES];
+extern ZobristKey g_zobristBlackTurnKey;
+
+/* The keys of each combination of castling rights (the xor of the keys of its flags), and of each en passant column. */
+extern ZobristKey g_zobristCastlingKeys[NUM_OF_CASTLING_RIGHTS];
+extern ZobristKey g_zobristEnPassantKeys[BOARD_SIZE];
+
+/* Returns the key of a soldier ('m', 'M', 'b', ...) standing on the square. */
+#define ZOBRIST_SOLDIER_KEY(soldier, square) \
+	(g_zobristPieceKeys[isBlackSoldier(soldier)][getPieceType(soldier)][(square)])
+
+/* Returns the key of the en passant square (0 for NO_EN_PASSANT_SQUARE). */
+#define ZOBRIST_EN_PASSANT_KEY(square) \
+	(((square) == NO_EN_PASSANT_SQUARE) ? 0 : g_zobristEnPassantKeys[SQUARE_COLUMN(square)])
+
+/*
+ * Fill the random key tables. The keys are generated from a fixed seed, so they are the same on every run.
+ * Called by computeZobristKey, so the tables are ready before any incremental update takes place.
+ */
+void initZobristKeys();
+
+/* Computes the key of the char board from scratch (used for boards that were set or loaded by the user). */
+ZobristKey computeZobristKey(char board[BOARD_SIZE][BOARD_SIZE], bool isBlackTurn, int castlingRights,
+							 int enPassantSquare);
+
+#endif